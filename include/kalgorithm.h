@@ -0,0 +1,11 @@
+#pragma once
+#include <utility>
+
+namespace kstd
+{
+  template<typename ForwardIt, typename Searcher>
+  ForwardIt search(ForwardIt first, ForwardIt last, const Searcher& searcher)
+  {
+    return searcher(first, last).first;
+  }
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "kstring.h"
+
+namespace kstd
+{
+  namespace detail
+  {
+    constexpr char digit_pairs[201] =
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899";
+
+    template<typename UInt>
+    constexpr std::size_t count_digits(UInt value) noexcept
+    {
+      std::size_t count = 1;
+      for (;;)
+      {
+        if (value < 10)
+          return count;
+        if (value < 100)
+          return count + 1;
+        if (value < 1000)
+          return count + 2;
+        if (value < 10000)
+          return count + 3;
+        value /= 10000;
+        count += 4;
+      }
+    }
+
+    template<typename UInt>
+    void write_digits(char* last, UInt value) noexcept
+    {
+      while (value >= 100)
+      {
+        std::size_t index = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--last = digit_pairs[index + 1];
+        *--last = digit_pairs[index];
+      }
+      if (value >= 10)
+      {
+        std::size_t index = static_cast<std::size_t>(value) * 2;
+        *--last = digit_pairs[index + 1];
+        *--last = digit_pairs[index];
+      }
+      else
+      {
+        *--last = static_cast<char>('0' + value);
+      }
+    }
+
+    template<typename Traits, typename Allocator, std::size_t InlineCapacity, typename Float, typename... Args>
+    void append_float(basic_string<char, Traits, Allocator, InlineCapacity>& str, Float value, Args... args)
+    {
+      std::size_t size_curr = str.size();
+      std::size_t reserve = 32;
+      for (bool done = false; !done; reserve *= 4)
+      {
+        str.resize_and_overwrite(size_curr + reserve, [&](char* buf, std::size_t count)
+        {
+          std::to_chars_result result = std::to_chars(buf + size_curr, buf + count, value, args...);
+          done = result.ec == std::errc();
+          return done ? static_cast<std::size_t>(result.ptr - buf) : size_curr;
+        });
+      }
+    }
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity, typename Integer>
+  basic_string<char, Traits, Allocator, InlineCapacity>& append_int(basic_string<char, Traits, Allocator, InlineCapacity>& str, Integer value)
+  {
+    static_assert(std::is_integral_v<Integer> && !std::is_same_v<Integer, bool>, "append_int requires an integer type");
+    using unsigned_type = std::make_unsigned_t<Integer>;
+    unsigned_type magnitude = static_cast<unsigned_type>(value);
+    bool negative = false;
+    if constexpr (std::is_signed_v<Integer>)
+    {
+      negative = value < 0;
+      if (negative)
+        magnitude = static_cast<unsigned_type>(unsigned_type(0) - magnitude);
+    }
+    std::size_t size_curr = str.size();
+    std::size_t len = negative + detail::count_digits(magnitude);
+    str.resize_and_overwrite(size_curr + len, [&](char* buf, std::size_t count)
+    {
+      if (negative)
+        buf[size_curr] = '-';
+      detail::write_digits(buf + count, magnitude);
+      return count;
+    });
+    return str;
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity>
+  basic_string<char, Traits, Allocator, InlineCapacity>& append_double(basic_string<char, Traits, Allocator, InlineCapacity>& str, double value)
+  {
+    detail::append_float(str, value);
+    return str;
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity>
+  basic_string<char, Traits, Allocator, InlineCapacity>& append_double(basic_string<char, Traits, Allocator, InlineCapacity>& str, double value, std::chars_format fmt)
+  {
+    detail::append_float(str, value, fmt);
+    return str;
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity>
+  basic_string<char, Traits, Allocator, InlineCapacity>& append_double(basic_string<char, Traits, Allocator, InlineCapacity>& str, double value, std::chars_format fmt, int precision)
+  {
+    detail::append_float(str, value, fmt, precision);
+    return str;
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity>
+  basic_string<char, Traits, Allocator, InlineCapacity>& append_float(basic_string<char, Traits, Allocator, InlineCapacity>& str, float value)
+  {
+    detail::append_float(str, value);
+    return str;
+  }
+
+  template<typename Integer>
+  std::from_chars_result from_chars(string_view str, Integer& value, int base = 10)
+  {
+    static_assert(std::is_integral_v<Integer> && !std::is_same_v<Integer, bool>, "from_chars requires an integer type");
+    return std::from_chars(str.data(), str.data() + str.size(), value, base);
+  }
+
+  inline std::from_chars_result from_chars(string_view str, double& value, std::chars_format fmt = std::chars_format::general)
+  {
+    return std::from_chars(str.data(), str.data() + str.size(), value, fmt);
+  }
+
+  inline std::from_chars_result from_chars(string_view str, float& value, std::chars_format fmt = std::chars_format::general)
+  {
+    return std::from_chars(str.data(), str.data() + str.size(), value, fmt);
+  }
+}
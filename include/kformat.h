@@ -0,0 +1,251 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "kvector.h"
+#include "kstring.h"
+#include "kcharconv.h"
+
+namespace kstd
+{
+  template<typename T, typename = void>
+  struct formatter;
+
+  template<typename T>
+  struct formatter<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>>
+  {
+    static std::size_t size(T value) noexcept
+    {
+      using unsigned_type = std::make_unsigned_t<T>;
+      unsigned_type magnitude = static_cast<unsigned_type>(value);
+      bool negative = false;
+      if constexpr (std::is_signed_v<T>)
+      {
+        negative = value < 0;
+        if (negative)
+          magnitude = static_cast<unsigned_type>(unsigned_type(0) - magnitude);
+      }
+      return negative + detail::count_digits(magnitude);
+    }
+
+    template<typename String>
+    static void format(String& str, T value)
+    {
+      append_int(str, value);
+    }
+  };
+
+  template<typename T>
+  struct formatter<T, std::enable_if_t<std::is_floating_point_v<T>>>
+  {
+    static std::size_t size(T) noexcept
+    {
+      // sign, decimal point and exponent around the shortest round-trip digits
+      return std::numeric_limits<T>::max_digits10 + 8;
+    }
+
+    template<typename String>
+    static void format(String& str, T value)
+    {
+      detail::append_float(str, value);
+    }
+  };
+
+  template<>
+  struct formatter<bool>
+  {
+    static std::size_t size(bool value) noexcept
+    {
+      return value ? 4 : 5;
+    }
+
+    template<typename String>
+    static void format(String& str, bool value)
+    {
+      if (value)
+        str.append("true", 4);
+      else
+        str.append("false", 5);
+    }
+  };
+
+  template<>
+  struct formatter<char>
+  {
+    static std::size_t size(char) noexcept
+    {
+      return 1;
+    }
+
+    template<typename String>
+    static void format(String& str, char value)
+    {
+      str.append(&value, 1);
+    }
+  };
+
+  template<typename Traits>
+  struct formatter<basic_string_view<char, Traits>>
+  {
+    static std::size_t size(basic_string_view<char, Traits> value) noexcept
+    {
+      return value.size();
+    }
+
+    template<typename String>
+    static void format(String& str, basic_string_view<char, Traits> value)
+    {
+      str.append(value.data(), value.size());
+    }
+  };
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity>
+  struct formatter<basic_string<char, Traits, Allocator, InlineCapacity>> : formatter<basic_string_view<char, Traits>> { };
+
+  template<>
+  struct formatter<const char*> : formatter<string_view> { };
+
+  template<>
+  struct formatter<char*> : formatter<string_view> { };
+
+  template<typename T, typename Allocator, typename Growth>
+  struct formatter<vector<T, Allocator, Growth>>
+  {
+    static std::size_t size(const vector<T, Allocator, Growth>& value) noexcept
+    {
+      std::size_t result = 2 + (value.empty() ? 0 : 2 * (value.size() - 1));
+      for (const T& elem : value)
+        result += formatter<T>::size(elem);
+      return result;
+    }
+
+    template<typename String>
+    static void format(String& str, const vector<T, Allocator, Growth>& value)
+    {
+      str.append("[", 1);
+      for (auto it = value.begin(); it != value.end(); ++it)
+      {
+        if (it != value.begin())
+          str.append(", ", 2);
+        formatter<T>::format(str, *it);
+      }
+      str.append("]", 1);
+    }
+  };
+
+  namespace detail
+  {
+    template<typename T, typename = void>
+    constexpr bool has_formatter_v = false;
+
+    template<typename T>
+    constexpr bool has_formatter_v<T, std::void_t<decltype(formatter<T>::size(std::declval<const T&>()))>> = true;
+
+    // returns the position one past the next replacement field, or size if there is none
+    template<typename String>
+    std::size_t format_literal(String& str, const char* fmt, std::size_t size, std::size_t pos)
+    {
+      while (pos < size)
+      {
+        std::size_t first = pos;
+        while (pos < size && fmt[pos] != '{' && fmt[pos] != '}')
+          ++pos;
+        str.append(fmt + first, pos - first);
+        if (pos == size)
+          break;
+        if (fmt[pos] == '{' && fmt[pos + 1] == '}')
+          return pos + 2;
+        // an escaped brace
+        str.append(fmt + pos, 1);
+        pos += 2;
+      }
+      return size;
+    }
+  }
+
+  template<typename... Args>
+  class basic_format_string
+  {
+  public:
+    template<typename String, typename = std::enable_if_t<std::is_convertible_v<const String&, const char*>>>
+    consteval basic_format_string(const String& fmt) : str_(fmt), size_(std::char_traits<char>::length(fmt))
+    {
+      std::size_t fields = 0;
+      for (std::size_t pos = 0; pos < size_; ++pos)
+      {
+        if (str_[pos] == '{')
+        {
+          if (pos + 1 == size_)
+            throw std::invalid_argument("unmatched '{' in format string");
+          if (str_[pos + 1] == '}')
+            ++fields;
+          else if (str_[pos + 1] != '{')
+            throw std::invalid_argument("only '{}' replacement fields are supported");
+          ++pos;
+        }
+        else if (str_[pos] == '}')
+        {
+          if (pos + 1 == size_ || str_[pos + 1] != '}')
+            throw std::invalid_argument("unmatched '}' in format string");
+          ++pos;
+        }
+        ++literal_size_;
+      }
+      literal_size_ -= fields;
+      if (fields != sizeof...(Args))
+        throw std::invalid_argument("argument count does not match the format string");
+    }
+
+    constexpr const char* data() const noexcept
+    {
+      return str_;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    constexpr std::size_t literal_size() const noexcept
+    {
+      return literal_size_;
+    }
+  private:
+    const char* str_;
+    std::size_t size_;
+    std::size_t literal_size_ = 0;
+  };
+
+  template<typename... Args>
+  using format_string = basic_format_string<std::type_identity_t<Args>...>;
+
+  template<typename... Args>
+  std::size_t formatted_size(format_string<Args...> fmt, const Args&... args) noexcept
+  {
+    static_assert((detail::has_formatter_v<std::decay_t<Args>> && ...), "no kstd::formatter for argument type");
+    return fmt.literal_size() + (formatter<std::decay_t<Args>>::size(args) + ... + 0);
+  }
+
+  template<typename Traits, typename Allocator, std::size_t InlineCapacity, typename... Args>
+  basic_string<char, Traits, Allocator, InlineCapacity>& format_to(basic_string<char, Traits, Allocator, InlineCapacity>& str, format_string<Args...> fmt, const Args&... args)
+  {
+    std::size_t size_new = str.size() + formatted_size<Args...>(fmt, args...);
+    if (size_new > str.capacity())
+      str.reserve(std::max(size_new, str.capacity() + str.capacity() / 2));
+    std::size_t pos = 0;
+    ((pos = detail::format_literal(str, fmt.data(), fmt.size(), pos), formatter<std::decay_t<Args>>::format(str, args)), ...);
+    detail::format_literal(str, fmt.data(), fmt.size(), pos);
+    return str;
+  }
+
+  template<typename... Args>
+  string format(format_string<Args...> fmt, const Args&... args)
+  {
+    string result;
+    format_to(result, fmt, args...);
+    return result;
+  }
+}
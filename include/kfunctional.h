@@ -0,0 +1,295 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <unordered_map>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace kstd
+{
+  namespace detail
+  {
+    template<typename T>
+    constexpr bool is_byte_like_v = std::is_integral_v<T> && sizeof(T) == 1;
+
+    template<typename T>
+    constexpr std::size_t byte_index(T value) noexcept
+    {
+      return static_cast<unsigned char>(value);
+    }
+
+    inline void multiply_128(std::uint64_t& lo, std::uint64_t& hi) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+      unsigned __int128 product = static_cast<unsigned __int128>(lo) * hi;
+      lo = static_cast<std::uint64_t>(product);
+      hi = static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+      lo = _umul128(lo, hi, &hi);
+#else
+      std::uint64_t a_lo = lo & 0xFFFFFFFF, a_hi = lo >> 32, b_lo = hi & 0xFFFFFFFF, b_hi = hi >> 32;
+      std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+      std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+      lo = (mid << 32) | (ll & 0xFFFFFFFF);
+      hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+    }
+
+    inline std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+      multiply_128(a, b);
+      return a ^ b;
+    }
+
+    inline std::uint64_t read_64(const unsigned char* ptr) noexcept
+    {
+      std::uint64_t value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    }
+
+    inline std::uint64_t read_32(const unsigned char* ptr) noexcept
+    {
+      std::uint32_t value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    }
+
+    constexpr std::uint64_t hash_secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+  }
+
+  // wyhash-style multiply-mix hash; three independent lanes over 48-byte blocks
+  inline std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed = 0) noexcept
+  {
+    using detail::hash_mix;
+    using detail::read_64;
+    using detail::read_32;
+    using detail::hash_secret;
+    const unsigned char* ptr = static_cast<const unsigned char*>(data);
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    if (size <= 16)
+    {
+      if (size >= 4)
+      {
+        a = (read_32(ptr) << 32) | read_32(ptr + ((size >> 3) << 2));
+        b = (read_32(ptr + size - 4) << 32) | read_32(ptr + size - 4 - ((size >> 3) << 2));
+      }
+      else if (size)
+      {
+        a = (std::uint64_t(ptr[0]) << 16) | (std::uint64_t(ptr[size >> 1]) << 8) | ptr[size - 1];
+      }
+    }
+    else
+    {
+      std::size_t left = size;
+      if (left > 48)
+      {
+        std::uint64_t seed_1 = seed;
+        std::uint64_t seed_2 = seed;
+        do
+        {
+          seed = hash_mix(read_64(ptr) ^ hash_secret[1], read_64(ptr + 8) ^ seed);
+          seed_1 = hash_mix(read_64(ptr + 16) ^ hash_secret[2], read_64(ptr + 24) ^ seed_1);
+          seed_2 = hash_mix(read_64(ptr + 32) ^ hash_secret[3], read_64(ptr + 40) ^ seed_2);
+          ptr += 48;
+          left -= 48;
+        }
+        while (left > 48);
+        seed ^= seed_1 ^ seed_2;
+      }
+      while (left > 16)
+      {
+        seed = hash_mix(read_64(ptr) ^ hash_secret[1], read_64(ptr + 8) ^ seed);
+        ptr += 16;
+        left -= 16;
+      }
+      a = read_64(ptr + left - 16);
+      b = read_64(ptr + left - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    detail::multiply_128(a, b);
+    return hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]);
+  }
+
+  template<typename T>
+  struct hash : std::hash<T> { };
+
+  template<typename RandomIt1>
+  class boyer_moore_horspool_searcher
+  {
+  public:
+    using value_type = typename std::iterator_traits<RandomIt1>::value_type;
+
+    boyer_moore_horspool_searcher(RandomIt1 pat_first, RandomIt1 pat_last) : pat_first_(pat_first), pat_size_(pat_last - pat_first)
+    {
+      if constexpr (detail::is_byte_like_v<value_type>)
+        std::fill(std::begin(shift_), std::end(shift_), pat_size_);
+      for (std::size_t i = 0; i + 1 < pat_size_; ++i)
+        set_shift(pat_first_[i], pat_size_ - 1 - i);
+    }
+
+    template<typename RandomIt2>
+    std::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first, RandomIt2 last) const
+    {
+      std::size_t size = last - first;
+      if (!pat_size_)
+        return {first, first};
+      if (pat_size_ > size)
+        return {last, last};
+      const value_type last_elem = pat_first_[pat_size_ - 1];
+      for (std::size_t pos = 0; pos <= size - pat_size_; pos += shift(first[pos + pat_size_ - 1]))
+      {
+        if (!(first[pos + pat_size_ - 1] == last_elem))
+          continue;
+        std::size_t i = 0;
+        while (i + 1 < pat_size_ && first[pos + i] == pat_first_[i])
+          ++i;
+        if (i + 1 == pat_size_)
+          return {first + pos, first + pos + pat_size_};
+      }
+      return {last, last};
+    }
+  private:
+    void set_shift(const value_type& value, std::size_t distance)
+    {
+      if constexpr (detail::is_byte_like_v<value_type>)
+        shift_[detail::byte_index(value)] = distance;
+      else
+        shift_[value] = distance;
+    }
+
+    template<typename T>
+    std::size_t shift(const T& value) const
+    {
+      if constexpr (detail::is_byte_like_v<value_type>)
+      {
+        return shift_[detail::byte_index(value)];
+      }
+      else
+      {
+        auto it = shift_.find(value);
+        return it == shift_.end() ? pat_size_ : it->second;
+      }
+    }
+
+    using shift_table = std::conditional_t<detail::is_byte_like_v<value_type>, std::size_t[256], std::unordered_map<value_type, std::size_t>>;
+
+    RandomIt1 pat_first_;
+    std::size_t pat_size_;
+    shift_table shift_ = {};
+  };
+
+  template<typename RandomIt1>
+  class two_way_searcher
+  {
+  public:
+    using value_type = typename std::iterator_traits<RandomIt1>::value_type;
+
+    two_way_searcher(RandomIt1 pat_first, RandomIt1 pat_last) : pat_first_(pat_first), pat_size_(pat_last - pat_first)
+    {
+      if (!pat_size_)
+        return;
+      std::ptrdiff_t period = 0;
+      std::ptrdiff_t period_reversed = 0;
+      std::ptrdiff_t suffix = maximal_suffix<false>(period);
+      std::ptrdiff_t suffix_reversed = maximal_suffix<true>(period_reversed);
+      if (suffix > suffix_reversed)
+      {
+        critical_ = suffix;
+        period_ = period;
+      }
+      else
+      {
+        critical_ = suffix_reversed;
+        period_ = period_reversed;
+      }
+      periodic_ = std::equal(pat_first_, pat_first_ + critical_ + 1, pat_first_ + period_);
+      if (!periodic_)
+        period_ = std::max(critical_ + 1, pat_size_ - critical_ - 1) + 1;
+    }
+
+    template<typename RandomIt2>
+    std::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first, RandomIt2 last) const
+    {
+      std::ptrdiff_t size = last - first;
+      if (!pat_size_)
+        return {first, first};
+      std::ptrdiff_t memory = -1;
+      for (std::ptrdiff_t pos = 0; pos <= size - pat_size_;)
+      {
+        std::ptrdiff_t i = (periodic_ ? std::max(critical_, memory) : critical_) + 1;
+        while (i < pat_size_ && pat_first_[i] == first[pos + i])
+          ++i;
+        if (i < pat_size_)
+        {
+          pos += i - critical_;
+          memory = -1;
+          continue;
+        }
+        std::ptrdiff_t stop = periodic_ ? memory : -1;
+        i = critical_;
+        while (i > stop && pat_first_[i] == first[pos + i])
+          --i;
+        if (i <= stop)
+          return {first + pos, first + pos + pat_size_};
+        pos += period_;
+        if (periodic_)
+          memory = pat_size_ - period_ - 1;
+      }
+      return {last, last};
+    }
+  private:
+    template<bool Reversed>
+    std::ptrdiff_t maximal_suffix(std::ptrdiff_t& period) const
+    {
+      std::ptrdiff_t suffix = -1;
+      std::ptrdiff_t j = 0;
+      std::ptrdiff_t k = 1;
+      period = 1;
+      while (j + k < pat_size_)
+      {
+        const value_type& a = pat_first_[j + k];
+        const value_type& b = pat_first_[suffix + k];
+        if (Reversed ? b < a : a < b)
+        {
+          j += k;
+          k = 1;
+          period = j - suffix;
+        }
+        else if (a == b)
+        {
+          if (k != period)
+          {
+            ++k;
+          }
+          else
+          {
+            j += period;
+            k = 1;
+          }
+        }
+        else
+        {
+          suffix = j++;
+          k = period = 1;
+        }
+      }
+      return suffix;
+    }
+
+    RandomIt1 pat_first_;
+    std::ptrdiff_t pat_size_;
+    std::ptrdiff_t critical_ = 0;
+    std::ptrdiff_t period_ = 1;
+    bool periodic_ = false;
+  };
+}
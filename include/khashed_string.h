@@ -0,0 +1,135 @@
+#pragma once
+#include "kstring.h"
+
+namespace kstd
+{
+  template<typename Elem, typename Traits = std::char_traits<Elem>, typename Allocator = caching_allocator<Elem>>
+  class basic_hashed_string
+  {
+  public:
+    using value_type = Elem;
+    using traits_type = Traits;
+    using allocator_type = Allocator;
+    using string_type = basic_string<Elem, Traits, Allocator>;
+    using view_type = basic_string_view<Elem, Traits>;
+    using size_type = std::size_t;
+    using const_iterator = const Elem*;
+
+    friend bool operator==(const basic_hashed_string& lhs, const basic_hashed_string& rhs) noexcept
+    {
+      return lhs.hash_ == rhs.hash_ && lhs.view() == rhs.view();
+    }
+
+    friend bool operator!=(const basic_hashed_string& lhs, const basic_hashed_string& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+
+    friend bool operator==(const basic_hashed_string& lhs, view_type rhs) noexcept
+    {
+      return lhs.view() == rhs;
+    }
+
+    friend bool operator!=(const basic_hashed_string& lhs, view_type rhs) noexcept
+    {
+      return lhs.view() != rhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const basic_hashed_string& str)
+    {
+      return os << str.view();
+    }
+
+    basic_hashed_string(const Allocator& alloc = Allocator()) : str_(alloc), hash_(compute(view_type())) { }
+
+    basic_hashed_string(view_type view, const Allocator& alloc = Allocator()) : str_(view, alloc), hash_(compute(view)) { }
+
+    basic_hashed_string(const Elem* str, const Allocator& alloc = Allocator()) : basic_hashed_string(view_type(str), alloc) { }
+
+    basic_hashed_string(const string_type& str) : str_(str), hash_(compute(str)) { }
+
+    basic_hashed_string(string_type&& str) noexcept : str_(std::move(str)), hash_(compute(str_)) { }
+
+    std::size_t hash() const noexcept
+    {
+      return hash_;
+    }
+
+    const string_type& str() const noexcept
+    {
+      return str_;
+    }
+
+    view_type view() const noexcept
+    {
+      return str_;
+    }
+
+    operator view_type() const noexcept
+    {
+      return str_;
+    }
+
+    const Elem* data() const noexcept
+    {
+      return str_.data();
+    }
+
+    const Elem* c_str() const noexcept
+    {
+      return str_.c_str();
+    }
+
+    size_type size() const noexcept
+    {
+      return str_.size();
+    }
+
+    bool empty() const noexcept
+    {
+      return str_.empty();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return str_.begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return str_.end();
+    }
+
+    string_type release() noexcept
+    {
+      string_type result(std::move(str_));
+      hash_ = compute(str_);
+      return result;
+    }
+  private:
+    static std::size_t compute(view_type view) noexcept
+    {
+      return kstd::hash<view_type>()(view);
+    }
+
+    string_type str_;
+    std::size_t hash_;
+  };
+
+  template<typename Elem, typename Traits, typename Allocator>
+  struct hash<basic_hashed_string<Elem, Traits, Allocator>>
+  {
+    std::size_t operator()(const basic_hashed_string<Elem, Traits, Allocator>& str) const noexcept
+    {
+      return str.hash();
+    }
+  };
+
+  template<typename Elem, typename Traits, typename Allocator>
+  struct is_trivially_relocatable<basic_hashed_string<Elem, Traits, Allocator>> : is_trivially_relocatable<basic_string<Elem, Traits, Allocator>> { };
+
+  using hashed_string = basic_hashed_string<char>;
+}
+
+template<typename Elem, typename Traits, typename Allocator>
+struct std::hash<kstd::basic_hashed_string<Elem, Traits, Allocator>> : kstd::hash<kstd::basic_hashed_string<Elem, Traits, Allocator>> { };
@@ -0,0 +1,234 @@
+#pragma once
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
+#include "kfunctional.h"
+#include "kstring_view.h"
+
+namespace kstd
+{
+  struct atom
+  {
+    static constexpr std::uint32_t invalid_id = UINT32_MAX;
+
+    friend constexpr bool operator==(atom lhs, atom rhs) noexcept
+    {
+      return lhs.id == rhs.id;
+    }
+
+    friend constexpr bool operator!=(atom lhs, atom rhs) noexcept
+    {
+      return lhs.id != rhs.id;
+    }
+
+    friend constexpr bool operator<(atom lhs, atom rhs) noexcept
+    {
+      return lhs.id < rhs.id;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+      return id != invalid_id;
+    }
+
+    std::uint32_t id = invalid_id;
+  };
+
+  class intern_pool
+  {
+    struct entry
+    {
+      const char* data;
+      std::size_t size;
+      std::uint64_t hash;
+    };
+
+    struct block
+    {
+      block* next;
+    };
+
+    struct alignas(64) shard
+    {
+      ~shard()
+      {
+        for (std::atomic<entry*>& segment : segments)
+          delete[] segment.load(std::memory_order_relaxed);
+        while (blocks)
+        {
+          block* next = blocks->next;
+          ::operator delete(blocks);
+          blocks = next;
+        }
+      }
+
+      const entry& at(std::uint32_t index) const noexcept
+      {
+        std::size_t segment = std::bit_width(index / segment_base + 1) - 1;
+        return segments[segment].load(std::memory_order_acquire)[index - segment_base * ((std::size_t(1) << segment) - 1)];
+      }
+
+      std::uint32_t find(string_view str, std::uint64_t hash) const noexcept
+      {
+        if (!slots)
+          return atom::invalid_id;
+        for (std::size_t i = hash & slot_mask;; i = (i + 1) & slot_mask)
+        {
+          std::uint32_t slot = slots[i];
+          if (!slot)
+            return atom::invalid_id;
+          const entry& e = at(slot - 1);
+          if (e.hash == hash && string_view(e.data, e.size) == str)
+            return slot - 1;
+        }
+      }
+
+      std::uint32_t insert(string_view str, std::uint64_t hash)
+      {
+        std::uint32_t index = find(str, hash);
+        if (index != atom::invalid_id)
+          return index;
+        index = count.load(std::memory_order_relaxed);
+        if (index == max_atoms)
+          throw std::length_error("intern_pool shard is full");
+        if ((index + 1) * 4 > (slot_mask + 1) * 3)
+          rehash();
+        std::size_t segment = std::bit_width(index / segment_base + 1) - 1;
+        entry* entries = segments[segment].load(std::memory_order_relaxed);
+        if (!entries)
+        {
+          entries = new entry[segment_base << segment];
+          segments[segment].store(entries, std::memory_order_release);
+        }
+        char* data = store(str);
+        entries[index - segment_base * ((std::size_t(1) << segment) - 1)] = {data, str.size(), hash};
+        std::size_t i = hash & slot_mask;
+        while (slots[i])
+          i = (i + 1) & slot_mask;
+        slots[i] = index + 1;
+        count.store(index + 1, std::memory_order_release);
+        return index;
+      }
+
+      void rehash()
+      {
+        std::size_t slot_count = slots ? (slot_mask + 1) * 2 : 64;
+        std::unique_ptr<std::uint32_t[]> new_slots(new std::uint32_t[slot_count]());
+        std::size_t new_mask = slot_count - 1;
+        std::uint32_t size = count.load(std::memory_order_relaxed);
+        for (std::uint32_t index = 0; index < size; ++index)
+        {
+          std::size_t i = at(index).hash & new_mask;
+          while (new_slots[i])
+            i = (i + 1) & new_mask;
+          new_slots[i] = index + 1;
+        }
+        slots = std::move(new_slots);
+        slot_mask = new_mask;
+      }
+
+      char* store(string_view str)
+      {
+        std::size_t size = str.size() + 1;
+        if (size > arena_left)
+        {
+          std::size_t block_size = std::max(size, arena_block_size);
+          block* ptr = static_cast<block*>(::operator new(sizeof(block) + block_size));
+          ptr->next = blocks;
+          blocks = ptr;
+          arena = reinterpret_cast<char*>(ptr + 1);
+          arena_left = block_size;
+        }
+        char* data = arena;
+        std::memcpy(data, str.data(), str.size());
+        data[str.size()] = '\0';
+        arena += size;
+        arena_left -= size;
+        return data;
+      }
+
+      mutable std::mutex mutex;
+      std::unique_ptr<std::uint32_t[]> slots;
+      std::size_t slot_mask = 0;
+      std::atomic<std::uint32_t> count = 0;
+      std::atomic<entry*> segments[32] = {};
+      block* blocks = nullptr;
+      char* arena = nullptr;
+      std::size_t arena_left = 0;
+    };
+  public:
+    static constexpr std::size_t shard_bits = 6;
+    static constexpr std::size_t shard_count = std::size_t(1) << shard_bits;
+    static constexpr std::uint32_t max_atoms = (std::uint32_t(1) << (32 - shard_bits)) - 1;
+
+    intern_pool() = default;
+
+    intern_pool(const intern_pool&) = delete;
+
+    intern_pool& operator=(const intern_pool&) = delete;
+
+    atom intern(string_view str)
+    {
+      std::uint64_t hash = hash_bytes(str.data(), str.size());
+      std::size_t shard_index = hash >> (64 - shard_bits);
+      shard& s = shards_[shard_index];
+      std::lock_guard<std::mutex> lock(s.mutex);
+      return {static_cast<std::uint32_t>((s.insert(str, hash) << shard_bits) | shard_index)};
+    }
+
+    string_view intern_view(string_view str)
+    {
+      return view(intern(str));
+    }
+
+    atom find(string_view str) const
+    {
+      std::uint64_t hash = hash_bytes(str.data(), str.size());
+      std::size_t shard_index = hash >> (64 - shard_bits);
+      const shard& s = shards_[shard_index];
+      std::lock_guard<std::mutex> lock(s.mutex);
+      std::uint32_t index = s.find(str, hash);
+      if (index == atom::invalid_id)
+        return {};
+      return {static_cast<std::uint32_t>((index << shard_bits) | shard_index)};
+    }
+
+    string_view view(atom a) const noexcept
+    {
+      const entry& e = shards_[a.id & (shard_count - 1)].at(a.id >> shard_bits);
+      return {e.data, e.size};
+    }
+
+    const char* c_str(atom a) const noexcept
+    {
+      return view(a).data();
+    }
+
+    std::size_t size() const noexcept
+    {
+      std::size_t total = 0;
+      for (const shard& s : shards_)
+        total += s.count.load(std::memory_order_relaxed);
+      return total;
+    }
+  private:
+    static constexpr std::size_t segment_base = 256;
+    static constexpr std::size_t arena_block_size = 64 * 1024;
+
+    shard shards_[shard_count];
+  };
+}
+
+template<>
+struct std::hash<kstd::atom>
+{
+  std::size_t operator()(kstd::atom a) const noexcept
+  {
+    return a.id;
+  }
+};
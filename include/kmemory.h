@@ -1,5 +1,11 @@
 #pragma once
+#include <new>
+#include <mutex>
+#include <atomic>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <utility>
 #include <type_traits>
 
@@ -9,6 +15,83 @@ namespace kstd
 {
   namespace detail
   {
+    template<typename Allocator, typename = void>
+    struct allocator_base
+    {
+    public:
+      allocator_base() noexcept(noexcept(Allocator())) : allocator_(Allocator()) { }
+
+      allocator_base(const Allocator& alloc) noexcept : allocator_(alloc) { }
+
+      allocator_base(Allocator&& alloc) noexcept : allocator_(std::move(alloc)) { }
+
+      allocator_base operator=(const Allocator& alloc)
+      {
+        if constexpr (traits::propagate_on_container_copy_assignment::value)
+          allocator() = alloc;
+        return *this;
+      }
+
+      allocator_base operator=(Allocator&& alloc) noexcept(traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value)
+      {
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+          allocator() = std::move(alloc);
+        return *this;
+      }
+
+      using traits = std::allocator_traits<Allocator>;
+    protected:
+      Allocator& allocator() noexcept
+      {
+        return allocator_;
+      }
+
+      const Allocator& allocator() const noexcept
+      {
+        return allocator_;
+      }
+    private:
+      Allocator allocator_;
+    };
+
+    template<typename Allocator>
+    struct allocator_base<Allocator, std::enable_if_t<!std::is_final_v<Allocator>>> : protected Allocator // protected because intellisense thinks inherited members are still accessable >:(
+    {
+    public:
+      allocator_base() noexcept(noexcept(Allocator())) : Allocator(Allocator()) { }
+
+      allocator_base(const Allocator& alloc) noexcept : Allocator(alloc) { }
+
+      allocator_base(Allocator&& alloc) noexcept : Allocator(std::move(alloc)) { }
+
+      allocator_base operator=(const Allocator& alloc)
+      {
+        if constexpr (traits::propagate_on_container_copy_assignment::value)
+          allocator() = alloc;
+        return *this;
+      }
+
+      allocator_base operator=(Allocator&& alloc) 
+        noexcept(traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value)
+      {
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+          allocator() = std::move(alloc);
+        return *this;
+      }
+
+      using traits = std::allocator_traits<Allocator>;
+    protected:
+      Allocator& allocator() noexcept
+      {
+        return *static_cast<Allocator*>(this);
+      }
+
+      const Allocator& allocator() const noexcept
+      {
+        return *static_cast<const Allocator*>(this);
+      }
+    };
+
     /*template<typename InputIterator, typename OutputIterator>
     OutputIterator uninitialized_move_range_optimal(InputIterator first, InputIterator last, OutputIterator d_first)
     {
@@ -105,4 +188,355 @@ namespace kstd
         std::fill(first, last, value);
     }*/
   }
+  struct allocation_stats
+  {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t oversized = 0;
+  };
+
+  namespace detail
+  {
+    // size classes of 32 to 256 bytes in 16 byte steps; slabs are never handed back to the system
+    class size_class_pool
+    {
+    public:
+      static constexpr std::size_t granularity = 16;
+      static constexpr std::size_t min_size = 32;
+      static constexpr std::size_t max_size = 256;
+      static constexpr std::size_t class_count = (max_size - min_size) / granularity + 1;
+      static constexpr std::size_t batch_size = 32;
+
+      struct block
+      {
+        block* next;
+        block* next_batch;
+        std::size_t count;
+      };
+
+      static std::size_t size_class(std::size_t bytes) noexcept
+      {
+        return bytes <= min_size ? 0 : (bytes - min_size + granularity - 1) / granularity;
+      }
+
+      static std::size_t class_bytes(std::size_t index) noexcept
+      {
+        return min_size + index * granularity;
+      }
+
+      static size_class_pool& instance()
+      {
+        static size_class_pool* pool = new size_class_pool();
+        return *pool;
+      }
+
+      block* acquire(std::size_t index)
+      {
+        central& list = central_[index];
+        {
+          std::lock_guard<std::mutex> lock(list.mutex);
+          if (block* batch = list.batches)
+          {
+            list.batches = batch->next_batch;
+            return batch;
+          }
+        }
+        std::size_t bytes = class_bytes(index);
+        char* slab = static_cast<char*>(::operator new(bytes * batch_size));
+        block* next = nullptr;
+        for (std::size_t i = batch_size; i-- > 0;)
+          next = ::new (static_cast<void*>(slab + i * bytes)) block{next, nullptr, 0};
+        next->count = batch_size;
+        return next;
+      }
+
+      void release(std::size_t index, block* batch) noexcept
+      {
+        central& list = central_[index];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        batch->next_batch = list.batches;
+        list.batches = batch;
+      }
+
+      void publish(const allocation_stats& delta) noexcept
+      {
+        hits_.fetch_add(delta.hits, std::memory_order_relaxed);
+        misses_.fetch_add(delta.misses, std::memory_order_relaxed);
+        oversized_.fetch_add(delta.oversized, std::memory_order_relaxed);
+      }
+
+      allocation_stats stats() const noexcept
+      {
+        return {hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed), oversized_.load(std::memory_order_relaxed)};
+      }
+    private:
+      struct alignas(64) central
+      {
+        std::mutex mutex;
+        block* batches = nullptr;
+      };
+
+      central central_[class_count];
+      std::atomic<std::uint64_t> hits_ = 0;
+      std::atomic<std::uint64_t> misses_ = 0;
+      std::atomic<std::uint64_t> oversized_ = 0;
+    };
+
+    class thread_cache
+    {
+      using block = size_class_pool::block;
+    public:
+      static constexpr std::size_t max_cached = 2 * size_class_pool::batch_size;
+
+      thread_cache() : pool_(size_class_pool::instance()) { }
+
+      thread_cache(const thread_cache&) = delete;
+
+      thread_cache& operator=(const thread_cache&) = delete;
+
+      ~thread_cache();
+
+      void* allocate(std::size_t index)
+      {
+        free_list& list = lists_[index];
+        if (list.head)
+        {
+          ++stats_.hits;
+        }
+        else
+        {
+          ++stats_.misses;
+          list.head = pool_.acquire(index);
+          list.count = list.head->count;
+          publish();
+        }
+        block* result = list.head;
+        list.head = result->next;
+        --list.count;
+        return result;
+      }
+
+      void deallocate(void* ptr, std::size_t index) noexcept
+      {
+        free_list& list = lists_[index];
+        list.head = ::new (ptr) block{list.head, nullptr, 0};
+        if (++list.count <= max_cached)
+          return;
+        block* batch = list.head;
+        block* last = batch;
+        for (std::size_t i = 1; i < size_class_pool::batch_size; ++i)
+          last = last->next;
+        list.head = last->next;
+        list.count -= size_class_pool::batch_size;
+        last->next = nullptr;
+        batch->count = size_class_pool::batch_size;
+        pool_.release(index, batch);
+      }
+
+      void count_oversized() noexcept
+      {
+        ++stats_.oversized;
+      }
+
+      const allocation_stats& stats() const noexcept
+      {
+        return stats_;
+      }
+    private:
+      struct free_list
+      {
+        block* head = nullptr;
+        std::size_t count = 0;
+      };
+
+      void publish() noexcept
+      {
+        pool_.publish({stats_.hits - published_.hits, stats_.misses - published_.misses, stats_.oversized - published_.oversized});
+        published_ = stats_;
+      }
+
+      size_class_pool& pool_;
+      free_list lists_[size_class_pool::class_count];
+      allocation_stats stats_;
+      allocation_stats published_;
+    };
+
+    inline thread_local bool thread_cache_destroyed = false;
+
+    inline thread_cache::~thread_cache()
+    {
+      for (std::size_t index = 0; index < size_class_pool::class_count; ++index)
+      {
+        if (!lists_[index].head)
+          continue;
+        lists_[index].head->count = lists_[index].count;
+        pool_.release(index, lists_[index].head);
+      }
+      publish();
+      thread_cache_destroyed = true;
+    }
+
+    inline thread_cache* local_thread_cache()
+    {
+      if (thread_cache_destroyed)
+        return nullptr;
+      thread_local thread_cache cache;
+      return &cache;
+    }
+
+    inline void* cached_allocate(std::size_t bytes)
+    {
+      std::size_t index = size_class_pool::size_class(bytes);
+      if (thread_cache* cache = local_thread_cache())
+        return cache->allocate(index);
+      size_class_pool& pool = size_class_pool::instance();
+      size_class_pool::block* batch = pool.acquire(index);
+      if (batch->next)
+      {
+        batch->next->count = batch->count - 1;
+        pool.release(index, batch->next);
+      }
+      return batch;
+    }
+
+    inline void cached_deallocate(void* ptr, std::size_t bytes) noexcept
+    {
+      std::size_t index = size_class_pool::size_class(bytes);
+      if (thread_cache* cache = local_thread_cache())
+        return cache->deallocate(ptr, index);
+      size_class_pool::instance().release(index, ::new (ptr) size_class_pool::block{nullptr, nullptr, 1});
+    }
+  }
+
+  template<typename T>
+  class caching_allocator
+  {
+    using pool = detail::size_class_pool;
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    caching_allocator() noexcept = default;
+
+    template<typename U>
+    caching_allocator(const caching_allocator<U>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+      if (cached(n))
+        return static_cast<T*>(detail::cached_allocate(n * sizeof(T)));
+      if (n > std::size_t(-1) / sizeof(T))
+        throw std::bad_array_new_length();
+      if (detail::thread_cache* cache = detail::local_thread_cache())
+        cache->count_oversized();
+      if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+      else
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+      if (cached(n))
+        detail::cached_deallocate(ptr, n * sizeof(T));
+      else if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t(alignof(T)));
+      else
+        ::operator delete(ptr);
+    }
+
+    static allocation_stats thread_stats() noexcept
+    {
+      detail::thread_cache* cache = detail::local_thread_cache();
+      return cache ? cache->stats() : allocation_stats();
+    }
+
+    static allocation_stats global_stats() noexcept
+    {
+      return pool::instance().stats();
+    }
+  private:
+    static bool cached(std::size_t n) noexcept
+    {
+      return alignof(T) <= pool::granularity && n <= pool::max_size / sizeof(T);
+    }
+  };
+
+  template<typename T, typename U>
+  bool operator==(const caching_allocator<T>&, const caching_allocator<U>&) noexcept
+  {
+    return true;
+  }
+
+  template<typename T, typename U>
+  bool operator!=(const caching_allocator<T>&, const caching_allocator<U>&) noexcept
+  {
+    return false;
+  }
+
+  // malloc/free backed allocator whose reallocate lets containers of trivially relocatable
+  // elements grow through realloc; glibc serves large blocks with mmap and grows them with mremap
+  template<typename T>
+  class malloc_allocator
+  {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc_allocator does not support over-aligned types");
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    malloc_allocator() noexcept = default;
+
+    template<typename U>
+    malloc_allocator(const malloc_allocator<U>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+      if (n > std::size_t(-1) / sizeof(T))
+        throw std::bad_array_new_length();
+      void* ptr = std::malloc(n * sizeof(T));
+      if (!ptr)
+        throw std::bad_alloc();
+      return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept
+    {
+      std::free(ptr);
+    }
+
+    // moves the elements bitwise; only valid for trivially relocatable T
+    T* reallocate(T* ptr, std::size_t, std::size_t n)
+    {
+      if (n > std::size_t(-1) / sizeof(T))
+        throw std::bad_array_new_length();
+      void* result = std::realloc(static_cast<void*>(ptr), n * sizeof(T));
+      if (!result)
+        throw std::bad_alloc();
+      return static_cast<T*>(result);
+    }
+  };
+
+  template<typename T, typename U>
+  bool operator==(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+  {
+    return true;
+  }
+
+  template<typename T, typename U>
+  bool operator!=(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+  {
+    return false;
+  }
+
+  namespace detail
+  {
+    template<typename Allocator, typename = void>
+    constexpr bool has_reallocate_v = false;
+
+    template<typename Allocator>
+    constexpr bool has_reallocate_v<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+      std::declval<typename std::allocator_traits<Allocator>::pointer>(), std::size_t(), std::size_t()))>> = true;
+  }
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace kstd
+{
+  enum class mmap_options : unsigned
+  {
+    none = 0,
+    // MAP_HUGETLB / MEM_LARGE_PAGES; needs reserved huge pages or the lock memory privilege, falls back to transparent huge pages
+    explicit_huge_pages = 1,
+    // fault every page in up front instead of on first touch
+    prefault = 2
+  };
+
+  constexpr mmap_options operator|(mmap_options lhs, mmap_options rhs) noexcept
+  {
+    return static_cast<mmap_options>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+  }
+
+  constexpr bool operator&(mmap_options lhs, mmap_options rhs) noexcept
+  {
+    return static_cast<unsigned>(lhs) & static_cast<unsigned>(rhs);
+  }
+
+  namespace detail
+  {
+    constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+    inline void touch_pages(void* ptr, std::size_t bytes) noexcept
+    {
+      volatile unsigned char* first = static_cast<unsigned char*>(ptr);
+      for (std::size_t i = 0; i < bytes; i += 4096)
+        first[i] = 0;
+    }
+
+#ifdef _WIN32
+    inline void* map_pages(std::size_t bytes, mmap_options options) noexcept
+    {
+      void* ptr = nullptr;
+      if (options & mmap_options::explicit_huge_pages)
+      {
+        std::size_t large = GetLargePageMinimum();
+        if (large && bytes % large == 0)
+          ptr = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+      }
+      if (!ptr)
+      {
+        ptr = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (ptr && (options & mmap_options::prefault))
+          touch_pages(ptr, bytes);
+      }
+      return ptr;
+    }
+
+    inline void unmap_pages(void* ptr, std::size_t) noexcept
+    {
+      VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+#else
+    // over-maps by a huge page and trims both ends so the region is huge page aligned, which transparent huge pages need
+    inline void* map_aligned(std::size_t bytes) noexcept
+    {
+      std::size_t padded = bytes + huge_page_size;
+      void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw == MAP_FAILED)
+        return nullptr;
+      std::uintptr_t first = reinterpret_cast<std::uintptr_t>(raw);
+      std::uintptr_t aligned = (first + huge_page_size - 1) & ~(huge_page_size - 1);
+      if (aligned != first)
+        munmap(raw, aligned - first);
+      if (std::size_t tail = first + padded - (aligned + bytes))
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+      return reinterpret_cast<void*>(aligned);
+    }
+
+    inline void advise_pages(void* ptr, std::size_t bytes, mmap_options options) noexcept
+    {
+#ifdef MADV_HUGEPAGE
+      madvise(ptr, bytes, MADV_HUGEPAGE);
+#endif
+      if (options & mmap_options::prefault)
+      {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(ptr, bytes, MADV_POPULATE_WRITE))
+#endif
+          touch_pages(ptr, bytes);
+      }
+    }
+
+    inline void* map_pages(std::size_t bytes, mmap_options options) noexcept
+    {
+#ifdef MAP_HUGETLB
+      if (options & mmap_options::explicit_huge_pages)
+      {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+        flags |= 21 << MAP_HUGE_SHIFT;
+#endif
+#ifdef MAP_POPULATE
+        if (options & mmap_options::prefault)
+          flags |= MAP_POPULATE;
+#endif
+        void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (ptr != MAP_FAILED)
+          return ptr;
+      }
+#endif
+      void* ptr = map_aligned(bytes);
+      if (ptr)
+        advise_pages(ptr, bytes, options);
+      return ptr;
+    }
+
+#ifdef MREMAP_FIXED
+    // resizes a map_pages region without copying; the result stays huge page aligned, either because
+    // the mapping grew or shrank in place or because it was moved onto a freshly reserved aligned range
+    inline void* remap_pages(void* ptr, std::size_t old_bytes, std::size_t bytes, mmap_options options) noexcept
+    {
+      void* result = mremap(ptr, old_bytes, bytes, 0);
+      if (result == MAP_FAILED)
+      {
+        void* target = map_aligned(bytes);
+        if (!target)
+          return nullptr;
+        result = mremap(ptr, old_bytes, bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+        if (result == MAP_FAILED)
+        {
+          munmap(target, bytes);
+          return nullptr;
+        }
+      }
+      if (bytes > old_bytes)
+        advise_pages(static_cast<unsigned char*>(result) + old_bytes, bytes - old_bytes, options);
+      return result;
+    }
+#endif
+
+    inline void unmap_pages(void* ptr, std::size_t bytes) noexcept
+    {
+      munmap(ptr, bytes);
+    }
+#endif
+  }
+
+  // serves requests of at least one huge page straight from the kernel, huge page aligned and
+  // rounded up to whole huge pages; smaller requests go through operator new
+  template<typename T, mmap_options Options = mmap_options::none>
+  class mmap_allocator
+  {
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind
+    {
+      using other = mmap_allocator<U, Options>;
+    };
+
+    static constexpr std::size_t min_mapped_size = detail::huge_page_size;
+
+    mmap_allocator() noexcept = default;
+
+    template<typename U>
+    mmap_allocator(const mmap_allocator<U, Options>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+      if (n > (std::size_t(-1) - 2 * detail::huge_page_size) / sizeof(T))
+        throw std::bad_array_new_length();
+      if (!mapped(n))
+        return allocate_small(n);
+      void* ptr = detail::map_pages(mapped_size(n), Options);
+      if (!ptr)
+        throw std::bad_alloc();
+      return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+      if (mapped(n))
+        detail::unmap_pages(ptr, mapped_size(n));
+      else
+        deallocate_small(ptr);
+    }
+
+    // moves the elements bitwise; only valid for trivially relocatable T
+    T* reallocate(T* ptr, std::size_t old_n, std::size_t n)
+    {
+      if (mapped(old_n) && mapped(n) && mapped_size(old_n) == mapped_size(n))
+        return ptr;
+#if defined(MREMAP_FIXED) && !defined(_WIN32)
+      if (!(Options & mmap_options::explicit_huge_pages) && mapped(old_n) && mapped(n))
+      {
+        void* result = detail::remap_pages(ptr, mapped_size(old_n), mapped_size(n), Options);
+        if (!result)
+          throw std::bad_alloc();
+        return static_cast<T*>(result);
+      }
+#endif
+      T* result = allocate(n);
+      std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr), std::min(old_n, n) * sizeof(T));
+      deallocate(ptr, old_n);
+      return result;
+    }
+  private:
+    static bool mapped(std::size_t n) noexcept
+    {
+      return n * sizeof(T) >= min_mapped_size;
+    }
+
+    static std::size_t mapped_size(std::size_t n) noexcept
+    {
+      return (n * sizeof(T) + detail::huge_page_size - 1) & ~(detail::huge_page_size - 1);
+    }
+
+    static T* allocate_small(std::size_t n)
+    {
+      if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+      else
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    static void deallocate_small(T* ptr) noexcept
+    {
+      if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t(alignof(T)));
+      else
+        ::operator delete(ptr);
+    }
+  };
+
+  template<typename T, typename U, mmap_options Options>
+  bool operator==(const mmap_allocator<T, Options>&, const mmap_allocator<U, Options>&) noexcept
+  {
+    return true;
+  }
+
+  template<typename T, typename U, mmap_options Options>
+  bool operator!=(const mmap_allocator<T, Options>&, const mmap_allocator<U, Options>&) noexcept
+  {
+    return false;
+  }
+}
@@ -0,0 +1,225 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <initializer_list>
+#include "ksimd.h"
+#include "kvector.h"
+#include "kstring_view.h"
+
+namespace kstd
+{
+  struct multi_match
+  {
+    std::size_t pattern;
+    std::size_t pos;
+    std::size_t size;
+  };
+
+  // Aho-Corasick automaton over byte classes; every transition is precomputed so a scan
+  // is a single table lookup per byte
+  class multi_searcher
+  {
+  public:
+    multi_searcher(std::initializer_list<string_view> patterns) : multi_searcher(patterns.begin(), patterns.end()) { }
+
+    template<typename InputIterator>
+    multi_searcher(InputIterator first, InputIterator last) : first_bytes_(nullptr, 0)
+    {
+      vector<string_view> patterns;
+      for (; first != last; ++first)
+        patterns.push_back(string_view(*first));
+      build(patterns);
+    }
+
+    std::size_t pattern_count() const noexcept
+    {
+      return lengths_.size();
+    }
+
+    std::size_t state_count() const noexcept
+    {
+      return next_.size() / classes_;
+    }
+
+    template<typename Function>
+    void for_each_match(string_view text, Function f) const
+    {
+      scan(text, [&](const multi_match& match)
+      {
+        f(match);
+        return false;
+      });
+    }
+
+    vector<multi_match> find_all(string_view text) const
+    {
+      vector<multi_match> result;
+      for_each_match(text, [&](const multi_match& match) { result.push_back(match); });
+      return result;
+    }
+
+    bool contains(string_view text) const
+    {
+      return scan(text, [](const multi_match&) { return true; });
+    }
+  private:
+    static constexpr std::uint32_t output_flag = std::uint32_t(1) << 31;
+    static constexpr std::uint32_t row_mask = output_flag - 1;
+    static constexpr std::uint32_t missing = std::numeric_limits<std::uint32_t>::max();
+    // with more distinct first bytes than this the root state is left too often for the prefilter to pay off
+    static constexpr std::size_t prefilter_limit = 16;
+
+    void build(const vector<string_view>& patterns)
+    {
+      bool used[256] = { };
+      bool first[256] = { };
+      for (string_view pattern : patterns)
+      {
+        for (char c : pattern)
+          used[static_cast<unsigned char>(c)] = true;
+        if (!pattern.empty())
+          first[static_cast<unsigned char>(pattern[0])] = true;
+      }
+      for (std::size_t c = 0; c < 256; ++c)
+        class_map_[c] = used[c] ? static_cast<std::uint16_t>(classes_++) : 0;
+
+      // trie; state 0 is the root and rows are indexed by state * classes_
+      next_.resize(classes_, missing);
+      vector<std::uint32_t> terminal;
+      for (string_view pattern : patterns)
+      {
+        lengths_.push_back(pattern.size());
+        std::uint32_t state = 0;
+        for (char c : pattern)
+        {
+          std::uint32_t& target = next_[state * classes_ + class_map_[static_cast<unsigned char>(c)]];
+          if (target == missing)
+          {
+            std::size_t count = state_count();
+            if ((count + 1) * classes_ > row_mask)
+              throw std::length_error("multi_searcher automaton too large");
+            target = static_cast<std::uint32_t>(count);
+            next_.resize(next_.size() + classes_, missing);
+          }
+          state = next_[state * classes_ + class_map_[static_cast<unsigned char>(c)]];
+        }
+        // empty patterns would match at every position and are never reported
+        terminal.push_back(pattern.empty() ? 0 : state);
+      }
+
+      // per state pattern lists, stored as offsets into a flat array
+      std::size_t states = state_count();
+      out_offsets_.resize(states + 1, 0);
+      for (std::uint32_t state : terminal)
+        if (state)
+          ++out_offsets_[state + 1];
+      for (std::size_t i = 0; i < states; ++i)
+        out_offsets_[i + 1] += out_offsets_[i];
+      out_patterns_.resize(out_offsets_[states]);
+      vector<std::uint32_t> fill(out_offsets_.begin(), out_offsets_.end() - 1);
+      for (std::size_t i = 0; i < terminal.size(); ++i)
+        if (terminal[i])
+          out_patterns_[fill[terminal[i]]++] = static_cast<std::uint32_t>(i);
+
+      // breadth first pass that bakes the failure links into the transition table; dict_ links
+      // each state to the nearest proper suffix state that reports a match
+      vector<std::uint32_t> fail(states, 0);
+      vector<std::uint32_t> report(states, 0);
+      dict_.resize(states, 0);
+      vector<std::uint32_t> queue;
+      queue.reserve(states);
+      for (std::size_t c = 0; c < classes_; ++c)
+      {
+        std::uint32_t& target = next_[c];
+        if (target == missing)
+          target = 0;
+        else
+          queue.push_back(target);
+      }
+      for (std::size_t head = 0; head < queue.size(); ++head)
+      {
+        std::uint32_t state = queue[head];
+        dict_[state] = report[fail[state]];
+        report[state] = out_offsets_[state] != out_offsets_[state + 1] ? state : dict_[state];
+        for (std::size_t c = 0; c < classes_; ++c)
+        {
+          std::uint32_t& target = next_[state * classes_ + c];
+          std::uint32_t fallback = next_[fail[state] * classes_ + c];
+          if (target == missing)
+          {
+            target = fallback;
+          }
+          else
+          {
+            fail[target] = fallback;
+            queue.push_back(target);
+          }
+        }
+      }
+
+      // premultiply the targets into row offsets and flag the rows that report a match
+      for (std::uint32_t& target : next_)
+        target = static_cast<std::uint32_t>(target * classes_) | (report[target] ? output_flag : 0);
+
+      char set[256];
+      std::size_t count = 0;
+      for (std::size_t c = 0; c < 256; ++c)
+        if (first[c])
+          set[count++] = static_cast<char>(c);
+      first_bytes_ = detail::byte_class(set, count);
+      prefilter_ = count <= prefilter_limit;
+    }
+
+    template<typename Function>
+    bool emit(std::size_t state, std::size_t end, Function& f) const
+    {
+      for (; state; state = dict_[state])
+      {
+        for (std::size_t i = out_offsets_[state]; i < out_offsets_[state + 1]; ++i)
+        {
+          std::size_t pattern = out_patterns_[i];
+          if (f(multi_match{pattern, end - lengths_[pattern], lengths_[pattern]}))
+            return true;
+        }
+      }
+      return false;
+    }
+
+    template<typename Function>
+    bool scan(string_view text, Function f) const
+    {
+      const unsigned char* str = reinterpret_cast<const unsigned char*>(text.data());
+      std::size_t size = text.size();
+      const std::uint32_t* next = next_.data();
+      const detail::byte_class_kernels& kernels = detail::byte_class_search();
+      std::uint32_t row = 0;
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        if (!row && prefilter_)
+        {
+          std::size_t skip = kernels.find(text.data() + i, size - i, first_bytes_);
+          if (skip == detail::simd_npos)
+            return false;
+          i += skip;
+        }
+        std::uint32_t target = next[row + class_map_[str[i]]];
+        row = target & row_mask;
+        if ((target & output_flag) && emit(row / classes_, i + 1, f))
+          return true;
+      }
+      return false;
+    }
+
+    std::uint16_t class_map_[256];
+    std::size_t classes_ = 1;
+    bool prefilter_ = false;
+    detail::byte_class first_bytes_;
+    vector<std::size_t> lengths_;
+    vector<std::uint32_t> next_;
+    vector<std::uint32_t> out_offsets_;
+    vector<std::uint32_t> out_patterns_;
+    vector<std::uint32_t> dict_;
+  };
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "kstring.h"
+
+namespace kstd
+{
+  template<typename Elem, typename Traits = std::char_traits<Elem>>
+  class basic_shared_string
+  {
+    struct header
+    {
+      std::atomic<std::size_t> refs;
+      std::size_t size;
+    };
+
+    static_assert(alignof(Elem) <= alignof(header), "unsupported element alignment");
+  public:
+    using value_type = Elem;
+    using traits_type = Traits;
+    using view_type = basic_string_view<Elem, Traits>;
+    using size_type = std::size_t;
+    using const_iterator = const Elem*;
+    using iterator = const_iterator;
+
+    friend bool operator==(const basic_shared_string& lhs, const basic_shared_string& rhs) noexcept
+    {
+      return lhs.header_ == rhs.header_ || lhs.view() == rhs.view();
+    }
+
+    friend bool operator!=(const basic_shared_string& lhs, const basic_shared_string& rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+
+    friend bool operator==(const basic_shared_string& lhs, view_type rhs) noexcept
+    {
+      return lhs.view() == rhs;
+    }
+
+    friend bool operator!=(const basic_shared_string& lhs, view_type rhs) noexcept
+    {
+      return lhs.view() != rhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const basic_shared_string& str)
+    {
+      return os << str.view();
+    }
+
+    basic_shared_string() noexcept = default;
+
+    explicit basic_shared_string(view_type str) : header_(make(str)) { }
+
+    explicit basic_shared_string(const Elem* str) : basic_shared_string(view_type(str)) { }
+
+    template<typename Allocator, std::size_t InlineCapacity>
+    explicit basic_shared_string(const basic_string<Elem, Traits, Allocator, InlineCapacity>& str) : basic_shared_string(view_type(str)) { }
+
+    basic_shared_string(const basic_shared_string& other) noexcept : header_(other.header_)
+    {
+      if (header_)
+        header_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    basic_shared_string(basic_shared_string&& other) noexcept : header_(std::exchange(other.header_, nullptr)) { }
+
+    basic_shared_string& operator=(const basic_shared_string& other) noexcept
+    {
+      basic_shared_string(other).swap(*this);
+      return *this;
+    }
+
+    basic_shared_string& operator=(basic_shared_string&& other) noexcept
+    {
+      basic_shared_string(std::move(other)).swap(*this);
+      return *this;
+    }
+
+    ~basic_shared_string()
+    {
+      if (header_ && header_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        header_->~header();
+        ::operator delete(header_);
+      }
+    }
+
+    void swap(basic_shared_string& other) noexcept
+    {
+      std::swap(header_, other.header_);
+    }
+
+    const Elem* data() const noexcept
+    {
+      static constexpr Elem empty = Elem();
+      return header_ ? reinterpret_cast<const Elem*>(header_ + 1) : &empty;
+    }
+
+    const Elem* c_str() const noexcept
+    {
+      return data();
+    }
+
+    size_type size() const noexcept
+    {
+      return header_ ? header_->size : 0;
+    }
+
+    size_type length() const noexcept
+    {
+      return size();
+    }
+
+    bool empty() const noexcept
+    {
+      return !size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+      return data() + size();
+    }
+
+    const Elem& operator[](size_type n) const noexcept
+    {
+      return data()[n];
+    }
+
+    view_type view() const noexcept
+    {
+      return {data(), size()};
+    }
+
+    operator view_type() const noexcept
+    {
+      return view();
+    }
+
+    template<typename String = basic_string<Elem, Traits>>
+    String str() const
+    {
+      return String(view());
+    }
+
+    size_type use_count() const noexcept
+    {
+      return header_ ? header_->refs.load(std::memory_order_relaxed) : 0;
+    }
+  private:
+    static header* make(view_type str)
+    {
+      if (str.empty())
+        return nullptr;
+      void* mem = ::operator new(sizeof(header) + (str.size() + 1) * sizeof(Elem));
+      header* result = ::new (mem) header{{1}, str.size()};
+      Elem* chars = reinterpret_cast<Elem*>(result + 1);
+      Traits::copy(chars, str.data(), str.size());
+      chars[str.size()] = Elem();
+      return result;
+    }
+
+    header* header_ = nullptr;
+  };
+
+  template<typename Elem, typename Traits>
+  struct hash<basic_shared_string<Elem, Traits>> : hash<basic_string_view<Elem, Traits>> { };
+
+  template<typename Elem, typename Traits>
+  struct is_trivially_relocatable<basic_shared_string<Elem, Traits>> : std::true_type { };
+
+  using shared_string = basic_shared_string<char>;
+}
+
+template<typename Elem, typename Traits>
+struct std::hash<kstd::basic_shared_string<Elem, Traits>> : kstd::hash<kstd::basic_string_view<Elem, Traits>> { };
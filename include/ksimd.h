@@ -0,0 +1,511 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define KSTD_SIMD_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(KSTD_SIMD_X64) && !defined(_MSC_VER)
+#define KSTD_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define KSTD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KSTD_TARGET_SSE42
+#define KSTD_TARGET_AVX2
+#endif
+
+namespace kstd
+{
+  namespace detail
+  {
+    constexpr std::size_t simd_npos = static_cast<std::size_t>(-1);
+
+    struct cpu_features
+    {
+      bool sse42 = false;
+      bool avx2 = false;
+    };
+
+    inline cpu_features detect_cpu_features() noexcept
+    {
+      cpu_features features;
+#ifdef KSTD_SIMD_X64
+      unsigned int regs[4] = {};
+#ifdef _MSC_VER
+      __cpuid(reinterpret_cast<int*>(regs), 0);
+      unsigned int max_leaf = regs[0];
+      __cpuid(reinterpret_cast<int*>(regs), 1);
+#else
+      unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+      __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+      features.sse42 = regs[2] & (1u << 20);
+      bool os_avx = false;
+      if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28)))
+      {
+#ifdef _MSC_VER
+        std::uint64_t xcr0 = _xgetbv(0);
+#else
+        unsigned int xcr0_lo = 0, xcr0_hi = 0;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        std::uint64_t xcr0 = (std::uint64_t(xcr0_hi) << 32) | xcr0_lo;
+#endif
+        os_avx = (xcr0 & 0x6) == 0x6;
+      }
+      if (os_avx && max_leaf >= 7)
+      {
+#ifdef _MSC_VER
+        __cpuidex(reinterpret_cast<int*>(regs), 7, 0);
+#else
+        __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        features.avx2 = regs[1] & (1u << 5);
+      }
+#endif
+      return features;
+    }
+
+    inline const cpu_features& cpu() noexcept
+    {
+      static const cpu_features features = detect_cpu_features();
+      return features;
+    }
+
+    struct byte_set
+    {
+      byte_set(const char* set, std::size_t count) noexcept
+      {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          unsigned char c = static_cast<unsigned char>(set[i]);
+          bits_[c >> 6] |= std::uint64_t(1) << (c & 63);
+        }
+      }
+
+      bool contains(char ch) const noexcept
+      {
+        unsigned char c = static_cast<unsigned char>(ch);
+        return (bits_[c >> 6] >> (c & 63)) & 1;
+      }
+    private:
+      std::uint64_t bits_[4] = {};
+    };
+
+    struct byte_class
+    {
+      byte_class(const char* set, std::size_t count) noexcept : bits(set, count)
+      {
+        for (unsigned int c = 0; c < 256; ++c)
+          if (bits.contains(static_cast<char>(c)))
+            (c < 128 ? rows_low : rows_high)[c & 15] |= static_cast<unsigned char>(1u << ((c >> 4) & 7));
+      }
+
+      bool contains(char ch) const noexcept
+      {
+        return bits.contains(ch);
+      }
+
+      byte_set bits;
+      alignas(16) unsigned char rows_low[16] = {};
+      alignas(16) unsigned char rows_high[16] = {};
+    };
+
+    // scalar kernels
+
+    inline std::size_t find_bytes_scalar(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count > size)
+        return simd_npos;
+      if (!count)
+        return 0;
+      const char* last = str + (size - count) + 1;
+      for (const char* it = str; it != last; ++it)
+      {
+        it = static_cast<const char*>(std::memchr(it, needle[0], last - it));
+        if (!it)
+          break;
+        if (!std::memcmp(it + 1, needle + 1, count - 1))
+          return it - str;
+      }
+      return simd_npos;
+    }
+
+    inline std::size_t rfind_bytes_scalar(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count > size)
+        return simd_npos;
+      if (!count)
+        return size;
+      for (std::size_t i = size - count + 1; i-- > 0;)
+        if (str[i] == needle[0] && !std::memcmp(str + i, needle, count))
+          return i;
+      return simd_npos;
+    }
+
+    inline std::size_t find_first_of_scalar(const char* str, std::size_t size, const char* set, std::size_t count) noexcept
+    {
+      byte_set bits(set, count);
+      for (std::size_t i = 0; i < size; ++i)
+        if (bits.contains(str[i]))
+          return i;
+      return simd_npos;
+    }
+
+    inline std::size_t find_first_not_of_scalar(const char* str, std::size_t size, const char* set, std::size_t count) noexcept
+    {
+      byte_set bits(set, count);
+      for (std::size_t i = 0; i < size; ++i)
+        if (!bits.contains(str[i]))
+          return i;
+      return simd_npos;
+    }
+
+    template<bool Negate>
+    std::size_t find_class_scalar(const char* str, std::size_t size, const byte_class& cls) noexcept
+    {
+      for (std::size_t i = 0; i < size; ++i)
+        if (cls.contains(str[i]) != Negate)
+          return i;
+      return simd_npos;
+    }
+
+    constexpr unsigned char ascii_fold(char ch) noexcept
+    {
+      unsigned char c = static_cast<unsigned char>(ch);
+      return static_cast<unsigned>(c - 'A') < 26u ? c | 0x20 : c;
+    }
+
+    inline std::size_t mismatch_ifold_scalar(const char* lhs, const char* rhs, std::size_t size) noexcept
+    {
+      for (std::size_t i = 0; i < size; ++i)
+        if (ascii_fold(lhs[i]) != ascii_fold(rhs[i]))
+          return i;
+      return simd_npos;
+    }
+
+#ifdef KSTD_SIMD_X64
+    // sse2 kernels (baseline on x64)
+
+    inline std::size_t find_bytes_sse2(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count < 2 || count > size)
+        return find_bytes_scalar(str, size, needle, count);
+      const __m128i first = _mm_set1_epi8(needle[0]);
+      const __m128i last = _mm_set1_epi8(needle[count - 1]);
+      std::size_t i = 0;
+      for (; i + count + 15 <= size; i += 16)
+      {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + count - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        for (; mask; mask &= mask - 1)
+        {
+          std::size_t pos = i + std::countr_zero(mask);
+          if (!std::memcmp(str + pos + 1, needle + 1, count - 2))
+            return pos;
+        }
+      }
+      std::size_t result = find_bytes_scalar(str + i, size - i, needle, count);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    inline std::size_t rfind_bytes_sse2(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count < 2 || count > size)
+        return rfind_bytes_scalar(str, size, needle, count);
+      const __m128i first = _mm_set1_epi8(needle[0]);
+      const __m128i last = _mm_set1_epi8(needle[count - 1]);
+      std::size_t end = size - count + 1;
+      for (; end >= 16; end -= 16)
+      {
+        std::size_t i = end - 16;
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + count - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask)
+        {
+          unsigned int bit = 31 - std::countl_zero(mask);
+          if (!std::memcmp(str + i + bit + 1, needle + 1, count - 2))
+            return i + bit;
+          mask ^= 1u << bit;
+        }
+      }
+      return rfind_bytes_scalar(str, end + count - 1, needle, count);
+    }
+
+    template<bool Negate>
+    std::size_t find_first_of_sse2(const char* str, std::size_t size, const char* set, std::size_t count) noexcept
+    {
+      if (count > 16)
+        return Negate ? find_first_not_of_scalar(str, size, set, count) : find_first_of_scalar(str, size, set, count);
+      __m128i needles[16];
+      for (std::size_t j = 0; j < count; ++j)
+        needles[j] = _mm_set1_epi8(set[j]);
+      std::size_t i = 0;
+      for (; i + 16 <= size; i += 16)
+      {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        __m128i matches = _mm_setzero_si128();
+        for (std::size_t j = 0; j < count; ++j)
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[j]));
+        unsigned int mask = _mm_movemask_epi8(matches);
+        if constexpr (Negate)
+          mask ^= 0xFFFF;
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = Negate ? find_first_not_of_scalar(str + i, size - i, set, count) : find_first_of_scalar(str + i, size - i, set, count);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    // maps 'A'..'Z' onto the lowest 26 signed bytes so one signed compare finds the upper case letters
+    inline __m128i ascii_fold_sse2(__m128i block) noexcept
+    {
+      __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(block, _mm_set1_epi8(0x80 - 'A')), _mm_set1_epi8(char(0x80 + 26)));
+      return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    }
+
+    inline std::size_t mismatch_ifold_sse2(const char* lhs, const char* rhs, std::size_t size) noexcept
+    {
+      std::size_t i = 0;
+      for (; i + 16 <= size; i += 16)
+      {
+        __m128i block_lhs = ascii_fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i)));
+        __m128i block_rhs = ascii_fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i)));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block_lhs, block_rhs)) ^ 0xFFFF;
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = mismatch_ifold_scalar(lhs + i, rhs + i, size - i);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    // sse4.2 kernels
+
+    template<bool Negate>
+    KSTD_TARGET_SSE42 std::size_t find_class_sse42(const char* str, std::size_t size, const byte_class& cls) noexcept
+    {
+      const __m128i rows_low = _mm_load_si128(reinterpret_cast<const __m128i*>(cls.rows_low));
+      const __m128i rows_high = _mm_load_si128(reinterpret_cast<const __m128i*>(cls.rows_high));
+      const __m128i row_bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(128), 1, 2, 4, 8, 16, 32, 64, char(128));
+      const __m128i nibble = _mm_set1_epi8(0x0F);
+      std::size_t i = 0;
+      for (; i + 16 <= size; i += 16)
+      {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        __m128i low = _mm_and_si128(block, nibble);
+        __m128i row = _mm_blendv_epi8(_mm_shuffle_epi8(rows_low, low), _mm_shuffle_epi8(rows_high, low), block);
+        __m128i bit = _mm_shuffle_epi8(row_bits, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+        if constexpr (Negate)
+          mask ^= 0xFFFF;
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = find_class_scalar<Negate>(str + i, size - i, cls);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    // avx2 kernels
+
+    KSTD_TARGET_AVX2 inline std::size_t find_bytes_avx2(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count < 2 || count > size)
+        return find_bytes_scalar(str, size, needle, count);
+      const __m256i first = _mm256_set1_epi8(needle[0]);
+      const __m256i last = _mm256_set1_epi8(needle[count - 1]);
+      std::size_t i = 0;
+      for (; i + count + 31 <= size; i += 32)
+      {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i + count - 1));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        for (; mask; mask &= mask - 1)
+        {
+          std::size_t pos = i + std::countr_zero(mask);
+          if (!std::memcmp(str + pos + 1, needle + 1, count - 2))
+            return pos;
+        }
+      }
+      std::size_t result = find_bytes_sse2(str + i, size - i, needle, count);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    KSTD_TARGET_AVX2 inline std::size_t rfind_bytes_avx2(const char* str, std::size_t size, const char* needle, std::size_t count) noexcept
+    {
+      if (count < 2 || count > size)
+        return rfind_bytes_scalar(str, size, needle, count);
+      const __m256i first = _mm256_set1_epi8(needle[0]);
+      const __m256i last = _mm256_set1_epi8(needle[count - 1]);
+      std::size_t end = size - count + 1;
+      for (; end >= 32; end -= 32)
+      {
+        std::size_t i = end - 32;
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i + count - 1));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        while (mask)
+        {
+          unsigned int bit = 31 - std::countl_zero(mask);
+          if (!std::memcmp(str + i + bit + 1, needle + 1, count - 2))
+            return i + bit;
+          mask ^= 1u << bit;
+        }
+      }
+      return rfind_bytes_sse2(str, end + count - 1, needle, count);
+    }
+
+    template<bool Negate>
+    KSTD_TARGET_AVX2 std::size_t find_first_of_avx2(const char* str, std::size_t size, const char* set, std::size_t count) noexcept
+    {
+      if (count > 16)
+        return Negate ? find_first_not_of_scalar(str, size, set, count) : find_first_of_scalar(str, size, set, count);
+      __m256i needles[16];
+      for (std::size_t j = 0; j < count; ++j)
+        needles[j] = _mm256_set1_epi8(set[j]);
+      std::size_t i = 0;
+      for (; i + 32 <= size; i += 32)
+      {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        __m256i matches = _mm256_setzero_si256();
+        for (std::size_t j = 0; j < count; ++j)
+          matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, needles[j]));
+        unsigned int mask = _mm256_movemask_epi8(matches);
+        if constexpr (Negate)
+          mask = ~mask;
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = find_first_of_sse2<Negate>(str + i, size - i, set, count);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    template<bool Negate>
+    KSTD_TARGET_AVX2 std::size_t find_class_avx2(const char* str, std::size_t size, const byte_class& cls) noexcept
+    {
+      const __m256i rows_low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(cls.rows_low)));
+      const __m256i rows_high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(cls.rows_high)));
+      const __m256i row_bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(128), 1, 2, 4, 8, 16, 32, 64, char(128),
+                                                1, 2, 4, 8, 16, 32, 64, char(128), 1, 2, 4, 8, 16, 32, 64, char(128));
+      const __m256i nibble = _mm256_set1_epi8(0x0F);
+      std::size_t i = 0;
+      for (; i + 32 <= size; i += 32)
+      {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+        __m256i low = _mm256_and_si256(block, nibble);
+        __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows_low, low), _mm256_shuffle_epi8(rows_high, low), block);
+        __m256i bit = _mm256_shuffle_epi8(row_bits, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+        if constexpr (Negate)
+          mask = ~mask;
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = find_class_sse42<Negate>(str + i, size - i, cls);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+
+    KSTD_TARGET_AVX2 inline __m256i ascii_fold_avx2(__m256i block) noexcept
+    {
+      __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + 26)), _mm256_add_epi8(block, _mm256_set1_epi8(0x80 - 'A')));
+      return _mm256_or_si256(block, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+    }
+
+    KSTD_TARGET_AVX2 inline std::size_t mismatch_ifold_avx2(const char* lhs, const char* rhs, std::size_t size) noexcept
+    {
+      std::size_t i = 0;
+      for (; i + 32 <= size; i += 32)
+      {
+        __m256i block_lhs = ascii_fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i)));
+        __m256i block_rhs = ascii_fold_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i)));
+        unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block_lhs, block_rhs)));
+        if (mask)
+          return i + std::countr_zero(mask);
+      }
+      std::size_t result = mismatch_ifold_sse2(lhs + i, rhs + i, size - i);
+      return result == simd_npos ? simd_npos : result + i;
+    }
+#endif
+
+    // runtime dispatch
+
+    using byte_search_fn = std::size_t(*)(const char*, std::size_t, const char*, std::size_t) noexcept;
+
+    struct byte_search_kernels
+    {
+      byte_search_fn find;
+      byte_search_fn rfind;
+      byte_search_fn find_first_of;
+      byte_search_fn find_first_not_of;
+    };
+
+    inline byte_search_kernels select_byte_search_kernels() noexcept
+    {
+#ifdef KSTD_SIMD_X64
+      if (cpu().avx2)
+        return {find_bytes_avx2, rfind_bytes_avx2, find_first_of_avx2<false>, find_first_of_avx2<true>};
+      return {find_bytes_sse2, rfind_bytes_sse2, find_first_of_sse2<false>, find_first_of_sse2<true>};
+#else
+      return {find_bytes_scalar, rfind_bytes_scalar, find_first_of_scalar, find_first_not_of_scalar};
+#endif
+    }
+
+    inline const byte_search_kernels& byte_search() noexcept
+    {
+      static const byte_search_kernels kernels = select_byte_search_kernels();
+      return kernels;
+    }
+
+    using byte_class_fn = std::size_t(*)(const char*, std::size_t, const byte_class&) noexcept;
+
+    struct byte_class_kernels
+    {
+      byte_class_fn find;
+      byte_class_fn find_not;
+    };
+
+    inline byte_class_kernels select_byte_class_kernels() noexcept
+    {
+#ifdef KSTD_SIMD_X64
+      if (cpu().avx2)
+        return {find_class_avx2<false>, find_class_avx2<true>};
+      if (cpu().sse42)
+        return {find_class_sse42<false>, find_class_sse42<true>};
+#endif
+      return {find_class_scalar<false>, find_class_scalar<true>};
+    }
+
+    inline const byte_class_kernels& byte_class_search() noexcept
+    {
+      static const byte_class_kernels kernels = select_byte_class_kernels();
+      return kernels;
+    }
+
+    using mismatch_fn = std::size_t(*)(const char*, const char*, std::size_t) noexcept;
+
+    inline mismatch_fn select_mismatch_ifold() noexcept
+    {
+#ifdef KSTD_SIMD_X64
+      if (cpu().avx2)
+        return mismatch_ifold_avx2;
+      return mismatch_ifold_sse2;
+#else
+      return mismatch_ifold_scalar;
+#endif
+    }
+
+    inline mismatch_fn mismatch_ifold() noexcept
+    {
+      static const mismatch_fn kernel = select_mismatch_ifold();
+      return kernel;
+    }
+  }
+}
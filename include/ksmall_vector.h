@@ -0,0 +1,551 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+#include "kmemory.h"
+#include "kvector.h"
+#include "ktype_traits.h"
+
+namespace kstd
+{
+  template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+  class small_vector : protected detail::allocator_base<Allocator>
+  {
+  public:
+    // typedefs
+    using value_type = T;
+    using allocator_type = Allocator;
+    using pointer = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    friend bool operator==(const small_vector& lhs, const small_vector& rhs)
+    {
+      return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const small_vector& lhs, const small_vector& rhs)
+    {
+      return !(lhs == rhs);
+    }
+
+    // constructors
+    small_vector() noexcept(noexcept(Allocator())) : small_vector(Allocator()) { }
+
+    explicit small_vector(const Allocator& alloc) noexcept : small_vector::allocator_base(alloc) { }
+
+    explicit small_vector(size_type n, const Allocator& alloc = Allocator()) : small_vector::allocator_base(alloc)
+    {
+      resize(n);
+    }
+
+    small_vector(size_type n, const T& value, const Allocator& alloc = Allocator()) : small_vector::allocator_base(alloc)
+    {
+      insert(end(), n, value);
+    }
+
+    template<class InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    small_vector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator()) : small_vector::allocator_base(alloc)
+    {
+      insert(end(), first, last);
+    }
+
+    small_vector(const small_vector& other) : small_vector::allocator_base(traits::select_on_container_copy_construction(other.allocator()))
+    {
+      insert(end(), other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector::allocator_base(std::move(other.allocator()))
+    {
+      take(other);
+    }
+
+    small_vector(std::initializer_list<T> list, const Allocator& alloc = Allocator()) : small_vector::allocator_base(alloc)
+    {
+      insert(end(), list.begin(), list.end());
+    }
+
+    ~small_vector()
+    {
+      detail::destroy_alloc(allocator(), data_, data_ + size_);
+      release();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+      if (this == &other)
+        return *this;
+      if constexpr (traits::propagate_on_container_copy_assignment::value)
+      {
+        if (allocator() != other.allocator())
+        {
+          clear();
+          release();
+        }
+        allocator() = other.allocator();
+      }
+      assign(other.begin(), other.end());
+      return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+      if (this == &other)
+        return *this;
+      clear();
+      if constexpr (traits::propagate_on_container_move_assignment::value)
+      {
+        release();
+        allocator() = std::move(other.allocator());
+      }
+      else if constexpr (!traits::is_always_equal::value)
+      {
+        if (allocator() != other.allocator())
+        {
+          insert(end(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+          other.clear();
+          return *this;
+        }
+      }
+      take(other);
+      return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> list)
+    {
+      assign(list.begin(), list.end());
+      return *this;
+    }
+
+    void assign(size_type n, const T& value)
+    {
+      clear();
+      insert(end(), n, value);
+    }
+
+    template<class InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    void assign(InputIterator first, InputIterator last)
+    {
+      clear();
+      insert(end(), first, last);
+    }
+
+    void assign(std::initializer_list<T> list)
+    {
+      assign(list.begin(), list.end());
+    }
+
+    Allocator get_allocator() const noexcept
+    {
+      return allocator();
+    }
+
+    // iterators
+    iterator begin() noexcept
+    {
+      return data_;
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return data_;
+    }
+
+    iterator end() noexcept
+    {
+      return data_ + size_;
+    }
+
+    const_iterator end() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+      return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+      return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+      return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+      return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+      return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+      return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+      return rend();
+    }
+
+    // capacity
+    bool empty() const noexcept
+    {
+      return !size_;
+    }
+
+    size_type size() const noexcept
+    {
+      return size_;
+    }
+
+    size_type max_size() const noexcept
+    {
+      return traits::max_size(allocator());
+    }
+
+    size_type capacity() const noexcept
+    {
+      return capacity_;
+    }
+
+    bool is_inline() const noexcept
+    {
+      return data_ == inline_data();
+    }
+
+    void resize(size_type sz)
+    {
+      if (sz < size_)
+      {
+        erase(data_ + sz, data_ + size_);
+      }
+      else if (sz > size_)
+      {
+        reserve(sz);
+        detail::uninitialized_default_fill_range_optimal_alloc(allocator(), data_ + size_, data_ + sz);
+        size_ = sz;
+      }
+    }
+
+    void resize(size_type sz, const T& value)
+    {
+      if (sz < size_)
+        erase(data_ + sz, data_ + size_);
+      else if (sz > size_)
+        insert(end(), sz - size_, value);
+    }
+
+    void reserve(size_type cap)
+    {
+      if (cap > capacity_)
+        reserve_offset(cap, size_, 0);
+    }
+
+    void shrink_to_fit()
+    {
+      if (is_inline() || size_ == capacity_)
+        return;
+      if (size_ <= N)
+        reallocate(inline_data(), N);
+      else
+        reallocate(traits::allocate(allocator(), size_), size_);
+    }
+
+    // element access
+    reference operator[](size_type n)
+    {
+      return data_[n];
+    }
+
+    const_reference operator[](size_type n) const
+    {
+      return data_[n];
+    }
+
+    reference at(size_type n)
+    {
+      if (n >= size_)
+        throw std::out_of_range("n is out of range");
+      return data_[n];
+    }
+
+    const_reference at(size_type n) const
+    {
+      if (n >= size_)
+        throw std::out_of_range("n is out of range");
+      return data_[n];
+    }
+
+    reference front()
+    {
+      return *data_;
+    }
+
+    const_reference front() const
+    {
+      return *data_;
+    }
+
+    reference back()
+    {
+      return data_[size_ - 1];
+    }
+
+    const_reference back() const
+    {
+      return data_[size_ - 1];
+    }
+
+    // data access
+    T* data() noexcept
+    {
+      return data_;
+    }
+
+    const T* data() const noexcept
+    {
+      return data_;
+    }
+
+    // modifiers
+    template<typename... Args>
+    reference emplace_back(Args&& ... args)
+    {
+      if (size_ == capacity_)
+      {
+        T value(std::forward<Args>(args)...);
+        reserve_offset(size_ + 1, size_, 0);
+        traits::construct(allocator(), data_ + size_, std::move(value));
+      }
+      else
+      {
+        traits::construct(allocator(), data_ + size_, std::forward<Args>(args)...);
+      }
+      ++size_;
+      return data_[size_ - 1];
+    }
+
+    void push_back(const T& value)
+    {
+      emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+      emplace_back(std::move(value));
+    }
+
+    void pop_back()
+    {
+      if constexpr (!std::is_trivially_destructible_v<T>)
+        traits::destroy(allocator(), data_ + size_ - 1);
+      --size_;
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&& ... args)
+    {
+      size_type emplaced_pos = pos - begin();
+      T value(std::forward<Args>(args)...);
+      if (size_ == capacity_)
+        reserve_offset(size_ + 1, emplaced_pos, 1);
+      else if (detail::shift_range_right_alloc(allocator(), data_ + emplaced_pos, data_ + size_, 1))
+      {
+        data_[emplaced_pos] = std::move(value);
+        ++size_;
+        return data_ + emplaced_pos;
+      }
+      traits::construct(allocator(), data_ + emplaced_pos, std::move(value));
+      ++size_;
+      return data_ + emplaced_pos;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+      return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+      return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+      size_type inserted_pos = pos - begin();
+      T copy(value);
+      if (size_ + count > capacity_)
+      {
+        reserve_offset(size_ + count, inserted_pos, count);
+        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos, data_ + inserted_pos + count, copy);
+      }
+      else
+      {
+        size_type live = detail::shift_range_right_alloc(allocator(), data_ + inserted_pos, data_ + size_, count);
+        detail::fill_range_optimal(data_ + inserted_pos, data_ + inserted_pos + live, copy);
+        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos + live, data_ + inserted_pos + count, copy);
+      }
+      size_ += count;
+      return data_ + inserted_pos;
+    }
+
+    template<typename InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+    {
+      size_type inserted_pos = pos - begin();
+      if constexpr (!detail::is_forward_iterator_v<InputIterator>)
+      {
+        return detail::insert_single_pass(*this, inserted_pos, first, last);
+      }
+      else
+      {
+        size_type count = std::distance(first, last);
+        if (size_ + count > capacity_)
+        {
+          reserve_offset(size_ + count, inserted_pos, count);
+          detail::uninitialized_copy_range_optimal_alloc(allocator(), first, last, data_ + inserted_pos);
+        }
+        else
+        {
+          size_type live = detail::shift_range_right_alloc(allocator(), data_ + inserted_pos, data_ + size_, count);
+          InputIterator middle = std::next(first, live);
+          detail::copy_range_optimal(first, middle, data_ + inserted_pos);
+          detail::uninitialized_copy_range_optimal_alloc(allocator(), middle, last, data_ + inserted_pos + live);
+        }
+        size_ += count;
+        return data_ + inserted_pos;
+      }
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> list)
+    {
+      return insert(pos, list.begin(), list.end());
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      size_type count = last - first;
+      size_type pos = first - begin();
+      detail::erase_range_alloc(allocator(), data_ + pos, data_ + pos + count, data_ + size_);
+      size_ -= count;
+      return data_ + pos;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+      return erase(pos, pos + 1);
+    }
+
+    void clear() noexcept
+    {
+      detail::destroy_alloc(allocator(), data_, data_ + size_);
+      size_ = 0;
+    }
+
+    void swap(small_vector& other)
+    {
+      small_vector temp(std::move(other));
+      other = std::move(*this);
+      *this = std::move(temp);
+    }
+  private:
+    pointer inline_data() noexcept
+    {
+      return reinterpret_cast<T*>(storage_);
+    }
+
+    const_pointer inline_data() const noexcept
+    {
+      return reinterpret_cast<const T*>(storage_);
+    }
+
+    // moves the elements into new_data, leaving a gap of count uninitialized elements at pos
+    void relocate(pointer new_data, size_type pos, size_type count)
+    {
+      detail::relocate_range_gap_alloc(allocator(), data_, data_ + pos, data_ + size_, new_data, count);
+    }
+
+    void reallocate(pointer new_data, size_type new_cap)
+    {
+      relocate(new_data, size_, 0);
+      release();
+      data_ = new_data;
+      capacity_ = new_cap;
+    }
+
+    void reserve_offset(size_type cap, size_type pos, size_type count)
+    {
+      size_type new_cap = std::max(cap, capacity_ * 2);
+      pointer new_data = traits::allocate(allocator(), new_cap);
+      relocate(new_data, pos, count);
+      release();
+      data_ = new_data;
+      capacity_ = new_cap;
+    }
+
+    // frees the heap buffer without touching the elements and falls back to the inline storage
+    void release() noexcept
+    {
+      if (!is_inline())
+        traits::deallocate(allocator(), data_, capacity_);
+      data_ = inline_data();
+      capacity_ = N;
+    }
+
+    void take(small_vector& other)
+    {
+      if (other.is_inline())
+      {
+        reserve(other.size_);
+        other.relocate(data_, other.size_, 0);
+        size_ = other.size_;
+        other.size_ = 0;
+      }
+      else
+      {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inline_data();
+        other.size_ = 0;
+        other.capacity_ = N;
+      }
+    }
+
+    using small_vector::allocator_base::allocator;
+    using traits = std::allocator_traits<Allocator>;
+
+    alignas(T) unsigned char storage_[N ? N * sizeof(T) : 1];
+    pointer data_ = inline_data();
+    size_type size_ = 0;
+    size_type capacity_ = N;
+  };
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "ksimd.h"
+#include "kstring_view.h"
+
+namespace kstd
+{
+  template<typename Elem, typename Traits = std::char_traits<Elem>>
+  class basic_split_range
+  {
+  public:
+    using view_type = basic_string_view<Elem, Traits>;
+
+    class iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = view_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const view_type*;
+      using reference = const view_type&;
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+      {
+        return lhs.pos_ == rhs.pos_;
+      }
+
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept
+      {
+        return lhs.pos_ != rhs.pos_;
+      }
+
+      iterator() = default;
+
+      reference operator*() const noexcept
+      {
+        return field_;
+      }
+
+      pointer operator->() const noexcept
+      {
+        return &field_;
+      }
+
+      iterator& operator++() noexcept
+      {
+        if (next_ == view_type::npos)
+          pos_ = view_type::npos;
+        else
+          load(next_ + range_->delim_size());
+        return *this;
+      }
+
+      iterator operator++(int) noexcept
+      {
+        iterator result = *this;
+        ++*this;
+        return result;
+      }
+    private:
+      friend class basic_split_range;
+
+      iterator(const basic_split_range* range, std::size_t pos) noexcept : range_(range)
+      {
+        if (pos == view_type::npos)
+          pos_ = pos;
+        else
+          load(pos);
+      }
+
+      void load(std::size_t pos) noexcept
+      {
+        pos_ = pos;
+        next_ = range_->find(pos);
+        field_ = view_type(range_->str_.data() + pos, (next_ == view_type::npos ? range_->str_.size() : next_) - pos);
+      }
+
+      const basic_split_range* range_ = nullptr;
+      std::size_t pos_ = view_type::npos;
+      std::size_t next_ = view_type::npos;
+      view_type field_;
+    };
+
+    using const_iterator = iterator;
+
+    basic_split_range(view_type str, view_type delim) noexcept : str_(str), delim_(delim) { }
+
+    basic_split_range(view_type str, Elem delim) noexcept : str_(str), delim_char_(delim), single_(true) { }
+
+    iterator begin() const noexcept
+    {
+      return iterator(this, str_.empty() ? view_type::npos : 0);
+    }
+
+    iterator end() const noexcept
+    {
+      return iterator(this, view_type::npos);
+    }
+
+    bool empty() const noexcept
+    {
+      return str_.empty();
+    }
+  private:
+    std::size_t delim_size() const noexcept
+    {
+      return single_ ? 1 : delim_.size();
+    }
+
+    std::size_t find(std::size_t pos) const noexcept
+    {
+      if (single_)
+        return str_.find(delim_char_, pos);
+      if (delim_.empty())
+        return view_type::npos;
+      return str_.find(delim_, pos);
+    }
+
+    view_type str_;
+    view_type delim_;
+    Elem delim_char_ = Elem();
+    bool single_ = false;
+  };
+
+  template<typename Elem, typename Traits = std::char_traits<Elem>>
+  class basic_token_range
+  {
+  public:
+    using view_type = basic_string_view<Elem, Traits>;
+
+    class iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = view_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const view_type*;
+      using reference = const view_type&;
+
+      friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+      {
+        return lhs.pos_ == rhs.pos_;
+      }
+
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept
+      {
+        return lhs.pos_ != rhs.pos_;
+      }
+
+      iterator() = default;
+
+      reference operator*() const noexcept
+      {
+        return token_;
+      }
+
+      pointer operator->() const noexcept
+      {
+        return &token_;
+      }
+
+      iterator& operator++() noexcept
+      {
+        load(pos_ + token_.size());
+        return *this;
+      }
+
+      iterator operator++(int) noexcept
+      {
+        iterator result = *this;
+        ++*this;
+        return result;
+      }
+    private:
+      friend class basic_token_range;
+
+      iterator(const basic_token_range* range, std::size_t pos) noexcept : range_(range)
+      {
+        load(pos);
+      }
+
+      void load(std::size_t pos) noexcept
+      {
+        pos_ = pos == view_type::npos ? pos : range_->find<true>(pos);
+        if (pos_ == view_type::npos)
+          return;
+        std::size_t last = range_->find<false>(pos_);
+        token_ = view_type(range_->str_.data() + pos_, (last == view_type::npos ? range_->str_.size() : last) - pos_);
+      }
+
+      const basic_token_range* range_ = nullptr;
+      std::size_t pos_ = view_type::npos;
+      view_type token_;
+    };
+
+    using const_iterator = iterator;
+
+    basic_token_range(view_type str, view_type set) noexcept : str_(str), set_(make_set(set)) { }
+
+    iterator begin() const noexcept
+    {
+      return iterator(this, 0);
+    }
+
+    iterator end() const noexcept
+    {
+      return iterator(this, view_type::npos);
+    }
+  private:
+    static constexpr bool byte_class_v = detail::has_byte_search_v<Elem, Traits>;
+
+    using set_type = std::conditional_t<byte_class_v, detail::byte_class, view_type>;
+
+    static set_type make_set(view_type set) noexcept
+    {
+      if constexpr (byte_class_v)
+        return detail::byte_class(reinterpret_cast<const char*>(set.data()), set.size());
+      else
+        return set;
+    }
+
+    template<bool Negate>
+    std::size_t find(std::size_t pos) const noexcept
+    {
+      if (pos >= str_.size())
+        return view_type::npos;
+      if constexpr (byte_class_v)
+      {
+        const detail::byte_class_kernels& kernels = detail::byte_class_search();
+        std::size_t result = (Negate ? kernels.find_not : kernels.find)(reinterpret_cast<const char*>(str_.data()) + pos, str_.size() - pos, set_);
+        return result == detail::simd_npos ? view_type::npos : result + pos;
+      }
+      else
+      {
+        return Negate ? str_.find_first_not_of(set_, pos) : str_.find_first_of(set_, pos);
+      }
+    }
+
+    view_type str_;
+    set_type set_;
+  };
+
+  template<typename Elem, typename Traits>
+  basic_split_range<Elem, Traits> split(basic_string_view<Elem, Traits> str, basic_string_view<Elem, Traits> delim) noexcept
+  {
+    return {str, delim};
+  }
+
+  template<typename Elem, typename Traits>
+  basic_split_range<Elem, Traits> split(basic_string_view<Elem, Traits> str, Elem delim) noexcept
+  {
+    return {str, delim};
+  }
+
+  inline basic_split_range<char> split(string_view str, string_view delim) noexcept
+  {
+    return {str, delim};
+  }
+
+  inline basic_split_range<char> split(string_view str, char delim) noexcept
+  {
+    return {str, delim};
+  }
+
+  template<typename Elem, typename Traits>
+  basic_token_range<Elem, Traits> tokenize(basic_string_view<Elem, Traits> str, basic_string_view<Elem, Traits> set) noexcept
+  {
+    return {str, set};
+  }
+
+  inline basic_token_range<char> tokenize(string_view str, string_view set) noexcept
+  {
+    return {str, set};
+  }
+}
@@ -0,0 +1,448 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+#include "kvector.h"
+#include "ktype_traits.h"
+
+namespace kstd
+{
+  template<typename T, std::size_t N>
+  class static_vector
+  {
+  public:
+    // typedefs
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    friend bool operator==(const static_vector& lhs, const static_vector& rhs)
+    {
+      return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const static_vector& lhs, const static_vector& rhs)
+    {
+      return !(lhs == rhs);
+    }
+
+    // constructors
+    static_vector() noexcept = default;
+
+    explicit static_vector(size_type n)
+    {
+      resize(n);
+    }
+
+    static_vector(size_type n, const T& value)
+    {
+      insert(end(), n, value);
+    }
+
+    template<class InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    static_vector(InputIterator first, InputIterator last)
+    {
+      insert(end(), first, last);
+    }
+
+    static_vector(std::initializer_list<T> list)
+    {
+      insert(end(), list.begin(), list.end());
+    }
+
+    // trivially copyable whenever T is
+    static_vector(const static_vector&) requires std::is_trivially_copyable_v<T> = default;
+
+    static_vector(const static_vector& other)
+    {
+      detail::uninitialized_copy_range_optimal_alloc(allocator(), other.begin(), other.end(), data());
+      size_ = other.size_;
+    }
+
+    static_vector(static_vector&&) requires std::is_trivially_copyable_v<T> = default;
+
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+      detail::uninitialized_move_range_optimal_alloc(allocator(), other.begin(), other.end(), data());
+      size_ = other.size_;
+    }
+
+    ~static_vector() requires std::is_trivially_destructible_v<T> = default;
+
+    ~static_vector()
+    {
+      detail::destroy_alloc(allocator(), begin(), end());
+    }
+
+    static_vector& operator=(const static_vector&) requires std::is_trivially_copyable_v<T> = default;
+
+    static_vector& operator=(const static_vector& other)
+    {
+      if (this != &other)
+        assign(other.begin(), other.end());
+      return *this;
+    }
+
+    static_vector& operator=(static_vector&&) requires std::is_trivially_copyable_v<T> = default;
+
+    static_vector& operator=(static_vector&& other) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    {
+      if (this == &other)
+        return *this;
+      size_type common = std::min(size_, other.size_);
+      detail::move_range_optimal(other.begin(), other.begin() + common, begin());
+      if (other.size_ > size_)
+        detail::uninitialized_move_range_optimal_alloc(allocator(), other.begin() + common, other.end(), end());
+      else
+        detail::destroy_alloc(allocator(), begin() + common, end());
+      size_ = other.size_;
+      return *this;
+    }
+
+    static_vector& operator=(std::initializer_list<T> list)
+    {
+      assign(list.begin(), list.end());
+      return *this;
+    }
+
+    void assign(size_type n, const T& value)
+    {
+      clear();
+      insert(end(), n, value);
+    }
+
+    template<class InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    void assign(InputIterator first, InputIterator last)
+    {
+      clear();
+      insert(end(), first, last);
+    }
+
+    void assign(std::initializer_list<T> list)
+    {
+      assign(list.begin(), list.end());
+    }
+
+    // iterators
+    iterator begin() noexcept
+    {
+      return data();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return data();
+    }
+
+    iterator end() noexcept
+    {
+      return data() + size_;
+    }
+
+    const_iterator end() const noexcept
+    {
+      return data() + size_;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+      return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+      return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+      return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+      return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+      return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+      return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept
+    {
+      return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept
+    {
+      return rend();
+    }
+
+    // capacity
+    bool empty() const noexcept
+    {
+      return !size_;
+    }
+
+    bool full() const noexcept
+    {
+      return size_ == N;
+    }
+
+    size_type size() const noexcept
+    {
+      return size_;
+    }
+
+    static constexpr size_type max_size() noexcept
+    {
+      return N;
+    }
+
+    static constexpr size_type capacity() noexcept
+    {
+      return N;
+    }
+
+    void reserve(size_type cap)
+    {
+      if (cap > N)
+        throw std::length_error("static_vector capacity exceeded");
+    }
+
+    void resize(size_type sz)
+    {
+      if (sz < size_)
+      {
+        erase(begin() + sz, end());
+      }
+      else if (sz > size_)
+      {
+        reserve(sz);
+        detail::uninitialized_default_fill_range_optimal_alloc(allocator(), end(), begin() + sz);
+        size_ = sz;
+      }
+    }
+
+    void resize(size_type sz, const T& value)
+    {
+      if (sz < size_)
+        erase(begin() + sz, end());
+      else if (sz > size_)
+        insert(end(), sz - size_, value);
+    }
+
+    // element access
+    reference operator[](size_type n)
+    {
+      return data()[n];
+    }
+
+    const_reference operator[](size_type n) const
+    {
+      return data()[n];
+    }
+
+    reference at(size_type n)
+    {
+      if (n >= size_)
+        throw std::out_of_range("n is out of range");
+      return data()[n];
+    }
+
+    const_reference at(size_type n) const
+    {
+      if (n >= size_)
+        throw std::out_of_range("n is out of range");
+      return data()[n];
+    }
+
+    reference front()
+    {
+      return *data();
+    }
+
+    const_reference front() const
+    {
+      return *data();
+    }
+
+    reference back()
+    {
+      return data()[size_ - 1];
+    }
+
+    const_reference back() const
+    {
+      return data()[size_ - 1];
+    }
+
+    // data access
+    T* data() noexcept
+    {
+      return reinterpret_cast<T*>(storage_);
+    }
+
+    const T* data() const noexcept
+    {
+      return reinterpret_cast<const T*>(storage_);
+    }
+
+    // modifiers
+    template<typename... Args>
+    reference emplace_back(Args&& ... args)
+    {
+      reserve(size_ + 1);
+      return emplace_back_unchecked(std::forward<Args>(args)...);
+    }
+
+    // the caller guarantees size() < capacity()
+    template<typename... Args>
+    reference emplace_back_unchecked(Args&& ... args)
+    {
+      traits::construct(allocator(), end(), std::forward<Args>(args)...);
+      return data()[size_++];
+    }
+
+    void push_back(const T& value)
+    {
+      emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+      emplace_back(std::move(value));
+    }
+
+    void push_back_unchecked(const T& value)
+    {
+      emplace_back_unchecked(value);
+    }
+
+    void push_back_unchecked(T&& value)
+    {
+      emplace_back_unchecked(std::move(value));
+    }
+
+    void pop_back()
+    {
+      if constexpr (!std::is_trivially_destructible_v<T>)
+        traits::destroy(allocator(), end() - 1);
+      --size_;
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&& ... args)
+    {
+      size_type emplaced_pos = pos - begin();
+      reserve(size_ + 1);
+      T value(std::forward<Args>(args)...);
+      if (detail::shift_range_right_alloc(allocator(), data() + emplaced_pos, end(), 1))
+        data()[emplaced_pos] = std::move(value);
+      else
+        traits::construct(allocator(), data() + emplaced_pos, std::move(value));
+      ++size_;
+      return data() + emplaced_pos;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+      return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+      return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+      size_type inserted_pos = pos - begin();
+      reserve(size_ + count);
+      T copy(value);
+      size_type live = detail::shift_range_right_alloc(allocator(), data() + inserted_pos, end(), count);
+      detail::fill_range_optimal(data() + inserted_pos, data() + inserted_pos + live, copy);
+      detail::uninitialized_fill_range_optimal_alloc(allocator(), data() + inserted_pos + live, data() + inserted_pos + count, copy);
+      size_ += count;
+      return data() + inserted_pos;
+    }
+
+    template<typename InputIterator, typename = std::enable_if_t<detail::is_iterator_v<InputIterator>>>
+    iterator insert(const_iterator pos, InputIterator first, InputIterator last)
+    {
+      size_type inserted_pos = pos - begin();
+      if constexpr (!detail::is_forward_iterator_v<InputIterator>)
+      {
+        return detail::insert_single_pass(*this, inserted_pos, first, last);
+      }
+      else
+      {
+        size_type count = std::distance(first, last);
+        reserve(size_ + count);
+        size_type live = detail::shift_range_right_alloc(allocator(), data() + inserted_pos, end(), count);
+        InputIterator middle = std::next(first, live);
+        detail::copy_range_optimal(first, middle, data() + inserted_pos);
+        detail::uninitialized_copy_range_optimal_alloc(allocator(), middle, last, data() + inserted_pos + live);
+        size_ += count;
+        return data() + inserted_pos;
+      }
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> list)
+    {
+      return insert(pos, list.begin(), list.end());
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      size_type count = last - first;
+      size_type pos = first - begin();
+      detail::erase_range_alloc(allocator(), data() + pos, data() + pos + count, end());
+      size_ -= count;
+      return data() + pos;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+      return erase(pos, pos + 1);
+    }
+
+    void clear() noexcept
+    {
+      detail::destroy_alloc(allocator(), begin(), end());
+      size_ = 0;
+    }
+  private:
+    using traits = std::allocator_traits<std::allocator<T>>;
+
+    // stateless; the range helpers construct and destroy through an allocator. It is a static data member because a
+    // function-local static would add an initialization guard check to every push
+    static std::allocator<T>& allocator() noexcept
+    {
+      return alloc_;
+    }
+
+    static inline std::allocator<T> alloc_;
+
+    alignas(T) unsigned char storage_[N ? N * sizeof(T) : 1];
+    size_type size_ = 0;
+  };
+}
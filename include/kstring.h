@@ -1,63 +1,170 @@
+#pragma once
 #include <cstring>
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <functional>
 #include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 #include "ktype_traits.h"
+#include "kmemory.h"
+#include "kstring_view.h"
 
 namespace kstd
 {
-  template<typename T>
-  struct char_traits { };
+  namespace detail
+  {
+    template<typename Elem, typename Traits>
+    struct concat_chars
+    {
+      std::size_t size() const noexcept
+      {
+        return size_;
+      }
 
-  template<>
-  struct char_traits<char>
+      Elem* copy_to(Elem* dest) const noexcept
+      {
+        Traits::copy(dest, data_, size_);
+        return dest + size_;
+      }
+
+      const Elem* data_;
+      std::size_t size_;
+    };
+
+    template<typename Elem>
+    struct concat_char
+    {
+      std::size_t size() const noexcept
+      {
+        return 1;
+      }
+
+      Elem* copy_to(Elem* dest) const noexcept
+      {
+        *dest = ch_;
+        return dest + 1;
+      }
+
+      Elem ch_;
+    };
+  }
+
+  template<typename String, typename Lhs, typename Rhs>
+  class string_concat;
+
+  namespace detail
   {
-    using char_type = char;
-    using int_type = int;
-    using off_type = std::size_t;
-    using pos_type = std::size_t;
+    template<typename Elem>
+    constexpr std::size_t default_inline_capacity_v = 3 * sizeof(Elem*) / sizeof(Elem) - 1;
 
-    static constexpr std::size_t length(const char_type* str)
+    template<typename Elem, typename Word, std::size_t Padding>
+    struct string_heap
     {
-      return std::strlen(str);
-    }
+      Elem* ptr;
+      Word capacity;
+      unsigned char padding[Padding];
+      Word size;
+    };
 
-    static constexpr void copy(char_type* dest, const char_type* src, std::size_t count)
+    template<typename Elem, typename Word>
+    struct string_heap<Elem, Word, 0>
     {
-      std::copy(src, src + count, dest);
-    }
+      Elem* ptr;
+      Word capacity;
+      Word size;
+    };
 
-    static constexpr void move(char_type* dest, const char_type* src, std::size_t count)
+    // the last byte of the object is the short size ((capacity - size) << 1) with bit 0 as the
+    // heap flag; on the heap it aliases the top byte of the size word, so the size skips bit 0 of it
+    template<typename Elem, std::size_t InlineCapacity>
+    struct string_layout
     {
-      std::move(src, src + count, dest);
-    }
-  };
+      static constexpr std::size_t min_bytes = std::max((InlineCapacity + 1) * sizeof(Elem), sizeof(Elem*) + 2 * sizeof(std::uint32_t));
+      static constexpr std::size_t bytes = (min_bytes + alignof(Elem*) - 1) / alignof(Elem*) * alignof(Elem*);
+      static constexpr std::size_t capacity = bytes / sizeof(Elem) - 1;
 
-  template<typename Elem, typename Traits = std::char_traits<Elem>>
-  class basic_string
+      using word = std::conditional_t<(bytes >= sizeof(Elem*) + 2 * sizeof(std::size_t)), std::size_t, std::uint32_t>;
+      using heap = string_heap<Elem, word, bytes - sizeof(Elem*) - 2 * sizeof(word)>;
+
+      static constexpr word heap_flag = word(1) << (sizeof(word) * 8 - 8);
+      static constexpr word low_mask = heap_flag - 1;
+      static constexpr std::size_t max_size = std::numeric_limits<word>::max() >> 1;
+
+      static_assert(bytes % sizeof(Elem) == 0 && capacity < 128, "unsupported inline capacity");
+
+      static word encode_size(std::size_t size) noexcept
+      {
+        return static_cast<word>((size & low_mask) | ((size & ~std::size_t(low_mask)) << 1) | heap_flag);
+      }
+
+      static std::size_t decode_size(word size) noexcept
+      {
+        return (size & low_mask) | ((size >> 1) & ~low_mask);
+      }
+    };
+  }
+
+  template<typename Elem, typename Traits = std::char_traits<Elem>, typename Allocator = caching_allocator<Elem>, std::size_t InlineCapacity = detail::default_inline_capacity_v<Elem>>
+  class basic_string : protected detail::allocator_base<Allocator>
   {
+    static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::pointer, Elem*>, "Allocator must use raw pointers");
+
+    using layout = detail::string_layout<Elem, InlineCapacity>;
   public:
     static const std::size_t npos = -1;
+    static constexpr std::size_t inline_capacity = layout::capacity;
+    using value_type = Elem;
+    using traits_type = Traits;
+    using allocator_type = Allocator;
+    using view_type = basic_string_view<Elem, Traits>;
+    using size_type = std::size_t;
     using iterator = Elem *;
     using const_iterator = const Elem*;
     using pointer = Elem *;
     using reference = Elem &;
     using const_reference = const Elem &;
 
-    friend basic_string operator+(const basic_string& lhs, const basic_string& rhs)
+    friend string_concat<basic_string, detail::concat_chars<Elem, Traits>, detail::concat_chars<Elem, Traits>> operator+(const basic_string& lhs, const basic_string& rhs)
+    {
+      return {{lhs.data(), lhs.size()}, {rhs.data(), rhs.size()}};
+    }
+
+    friend string_concat<basic_string, detail::concat_chars<Elem, Traits>, detail::concat_chars<Elem, Traits>> operator+(const basic_string& lhs, const Elem* rhs)
+    {
+      return {{lhs.data(), lhs.size()}, {rhs, Traits::length(rhs)}};
+    }
+
+    friend string_concat<basic_string, detail::concat_chars<Elem, Traits>, detail::concat_chars<Elem, Traits>> operator+(const Elem* lhs, const basic_string& rhs)
+    {
+      return {{lhs, Traits::length(lhs)}, {rhs.data(), rhs.size()}};
+    }
+
+    friend string_concat<basic_string, detail::concat_chars<Elem, Traits>, detail::concat_char<Elem>> operator+(const basic_string& lhs, Elem rhs)
+    {
+      return {{lhs.data(), lhs.size()}, {rhs}};
+    }
+
+    friend string_concat<basic_string, detail::concat_char<Elem>, detail::concat_chars<Elem, Traits>> operator+(Elem lhs, const basic_string& rhs)
+    {
+      return {{lhs}, {rhs.data(), rhs.size()}};
+    }
+
+    friend basic_string operator+(basic_string&& lhs, const basic_string& rhs)
     {
-      return basic_string{lhs}.append(rhs);
+      return std::move(lhs.append(rhs));
     }
 
-    friend basic_string operator+(const basic_string& lhs, const Elem* rhs)
+    friend basic_string operator+(basic_string&& lhs, const Elem* rhs)
     {
-      return basic_string{lhs}.append(rhs);
+      return std::move(lhs.append(rhs));
     }
 
-    friend basic_string operator+(const basic_string& lhs, Elem rhs)
+    friend basic_string operator+(basic_string&& lhs, Elem rhs)
     {
-      return basic_string{lhs}.append(rhs);
+      return std::move(lhs.append(rhs));
     }
 
     friend std::ostream& operator<<(std::ostream& lhs, const basic_string& rhs)
@@ -72,103 +179,117 @@ namespace kstd
       return lhs;
     }
 
-    basic_string()
+    basic_string() noexcept(noexcept(Allocator())) : basic_string(Allocator()) { }
+
+    explicit basic_string(const Allocator& alloc) noexcept : basic_string::allocator_base(alloc)
     {
       set_size(0);
     }
 
-    basic_string(const basic_string& other)
+    basic_string(const basic_string& other) : basic_string::allocator_base(alloc_traits::select_on_container_copy_construction(other.allocator()))
     {
-      std::size_t size_curr = other.size();
-      reserve(other.capacity());
-      if (size_curr)
-        Traits::copy(begin(), other.begin(), size_curr + 1);
-      set_size(size_curr);
+      set_size(0);
+      assign_chars(other.data(), other.size());
     }
 
-    basic_string(basic_string && other)
+    basic_string(const basic_string& other, const Allocator& alloc) : basic_string::allocator_base(alloc)
     {
-      if (other.on_heap())
-      {
-        set_heap_ptr(other.heap_ptr());
-        other.set_heap_ptr(nullptr);
-      }
-      else
-      {
-        Traits::copy(begin(), other.begin(), other.size() + 1);
-      }
-      set_on_heap(other.on_heap());
-      set_size(other.size());
-      set_capacity(other.capacity());
-      other.set_on_heap(false);
+      set_size(0);
+      assign_chars(other.data(), other.size());
+    }
+
+    basic_string(basic_string && other) noexcept : basic_string::allocator_base(std::move(other.allocator()))
+    {
+      set_size(0);
+      take(other);
     }
 
     basic_string& operator=(const basic_string & other)
     {
-      std::size_t size = other.size();
-      reserve(other.capacity());
-      if (size)
-        Traits::copy(begin(), other.begin(), size + 1);
-      set_size(size);
+      if (this == &other)
+        return *this;
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+      {
+        if constexpr (!alloc_traits::is_always_equal::value)
+          if (allocator() != other.allocator())
+            release();
+        allocator() = other.allocator();
+      }
+      assign_chars(other.data(), other.size());
       return *this;
     }
 
     basic_string& operator=(basic_string && other)
+      noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
     {
-      if (other.on_heap())
-      {
-        set_heap_ptr(other.heap_ptr());
-        other.set_heap_ptr(nullptr);
-        if (!on_heap())
-          set_on_heap(true);
-      }
-      else
+      if (this == &other)
+        return *this;
+      if constexpr (!alloc_traits::propagate_on_container_move_assignment::value && !alloc_traits::is_always_equal::value)
       {
-        Traits::copy(begin(), other.begin(), other.size() + 1);
+        if (allocator() != other.allocator())
+        {
+          assign_chars(other.data(), other.size());
+          return *this;
+        }
       }
-      set_size(other.size());
-      set_capacity(other.capacity());
-      other.set_on_heap(false);
+      release();
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+        allocator() = std::move(other.allocator());
+      take(other);
       return *this;
     }
 
-    basic_string(const Elem * str)
+    basic_string(const Elem * str, const Allocator& alloc = Allocator()) : basic_string(str, Traits::length(str), alloc) { }
+
+    basic_string(const Elem * str, std::size_t count, const Allocator& alloc = Allocator()) : basic_string::allocator_base(alloc)
     {
-      std::size_t size = Traits::length(str);
-      reserve(size);
-      Traits::copy(begin(), str, size + 1);
-      set_size(size);
+      set_size(0);
+      assign_chars(str, count);
     }
 
-    basic_string(const_iterator first, const_iterator last)
+    basic_string(const_iterator first, const_iterator last, const Allocator& alloc = Allocator()) : basic_string(first, last - first, alloc) { }
+
+    explicit basic_string(view_type str, const Allocator& alloc = Allocator()) : basic_string(str.data(), str.size(), alloc) { }
+
+    template<typename Lhs, typename Rhs>
+    basic_string(const string_concat<basic_string, Lhs, Rhs>& concat, const Allocator& alloc = Allocator()) : basic_string::allocator_base(alloc)
     {
-      std::size_t size_curr = last - first;
+      std::size_t size_curr = concat.size();
+      set_size(0);
       reserve(size_curr);
-      Traits::copy(begin(), first, size_curr + 1);
-      data()[size_curr] = 0;
+      *concat.copy_to(begin()) = Elem();
       set_size(size_curr);
     }
 
+    basic_string& operator=(view_type str)
+    {
+      assign_chars(str.data(), str.size());
+      return *this;
+    }
+
     basic_string& operator=(const Elem * str)
     {
-      std::size_t size = Traits::length(str);
-      reserve(size);
-      Traits::copy(begin(), str, size + 1);
-      set_size(size);
+      assign_chars(str, Traits::length(str));
       return *this;
     }
 
+    Allocator get_allocator() const noexcept
+    {
+      return allocator();
+    }
+
     void reserve(std::size_t cap)
     {
-      if (cap <= capacity() || cap <= 23)
+      if (cap <= capacity() || cap <= inline_capacity)
         return;
+      if (cap > max_size())
+        throw std::length_error("basic_string too long");
       std::size_t size_curr = size();
-      Elem * mem = new Elem[cap + 1];
-      if (size_curr)
-        Traits::copy(mem, begin(), size_curr + 1);
+      Elem * mem = alloc_traits::allocate(allocator(), cap + 1);
+      Traits::copy(mem, begin(), size_curr + 1);
       if (on_heap())
       {
-        delete[] data();
+        alloc_traits::deallocate(allocator(), data(), capacity() + 1);
       }
       else
       {
@@ -205,16 +326,23 @@ namespace kstd
       resize(size, Elem{});
     }
 
+    template<typename Operation>
+    void resize_and_overwrite(std::size_t count, Operation op)
+    {
+      grow(count);
+      std::size_t size_new = std::move(op)(data(), count);
+      data()[size_new] = Elem();
+      set_size(size_new);
+    }
+
     basic_string& erase(std::size_t pos, std::size_t count)
     {
       std::size_t size_curr = size();
       if (pos > size_curr)
         throw std::out_of_range("pos is bigger than size");
+      count = std::min(count, size_curr - pos);
       iterator begin_curr = begin();
-      if (count < size_curr)
-        Traits::copy(begin_curr + pos, begin_curr + pos + count, (size_curr + 1) - (pos + count));
-      else
-        *begin_curr = 0;
+      Traits::move(begin_curr + pos, begin_curr + pos + count, (size_curr + 1) - (pos + count));
       set_size(size_curr - count);
       return *this;
     }
@@ -242,15 +370,11 @@ namespace kstd
     basic_string& append(const Elem * str, std::size_t len)
     {
       std::size_t size_curr = size();
-      iterator begin_curr = begin();
-      iterator end_curr = end();
-      bool inside = std::any_of(begin_curr, end_curr, [&str](const Elem & val) { return &val == str; });
-      std::size_t offset = 0;
-      if (inside)
-        offset = str - begin_curr;
-      reserve(size_curr + len);
+      bool inside = aliases(str, len);
+      std::size_t offset = inside ? str - begin() : 0;
+      grow(size_curr + len);
       if (inside)
-        Traits::copy(begin() + size_curr, begin() + offset, len);
+        Traits::move(begin() + size_curr, begin() + offset, len);
       else
         Traits::copy(begin() + size_curr, str, len);
       set_size(size_curr + len);
@@ -263,11 +387,30 @@ namespace kstd
       return append(str, Traits::length(str));
     }
 
-    basic_string& append(const basic_string & str)
+    basic_string& append(view_type str)
     {
       return append(str.data(), str.size());
     }
 
+    template<typename Lhs, typename Rhs>
+    basic_string& append(const string_concat<basic_string, Lhs, Rhs>& concat)
+    {
+      std::size_t size_curr = size();
+      std::size_t len = concat.size();
+      if (size_curr + len > capacity())
+      {
+        basic_string result(allocator());
+        result.reserve(recommended_capacity(size_curr + len));
+        Traits::copy(result.begin(), begin(), size_curr);
+        *concat.copy_to(result.begin() + size_curr) = Elem();
+        result.set_size(size_curr + len);
+        return *this = std::move(result);
+      }
+      *concat.copy_to(begin() + size_curr) = Elem();
+      set_size(size_curr + len);
+      return *this;
+    }
+
     basic_string& append(Elem ch)
     {
       return append(&ch, 1);
@@ -289,19 +432,29 @@ namespace kstd
       std::size_t size_curr = size();
       if (pos > size_curr)
         throw std::out_of_range("pos is bigger than size");
+      bool inside = aliases(str, len);
+      std::size_t offset = inside ? str - begin() : 0;
+      grow(size_curr + len);
       iterator begin_curr = begin();
-      iterator end_curr = end();
-      bool inside = std::any_of(begin_curr, end_curr, [&str](const Elem & val) { return &val == str; });
-      std::size_t offset = 0;
-      if (inside)
-        offset = str - begin_curr;
-      reserve(size_curr + len);
-      begin_curr = begin();
-      Traits::copy(begin_curr + pos + len, begin_curr + pos, end() - (begin_curr + pos));
-      if (inside)
+      Traits::move(begin_curr + pos + len, begin_curr + pos, size_curr - pos + 1);
+      if (!inside)
+      {
+        Traits::copy(begin_curr + pos, str, len);
+      }
+      else if (offset + len <= pos)
+      {
         Traits::copy(begin_curr + pos, begin_curr + offset, len);
+      }
+      else if (offset >= pos)
+      {
+        Traits::copy(begin_curr + pos, begin_curr + offset + len, len);
+      }
       else
-        Traits::copy(begin_curr + pos, str, len);
+      {
+        std::size_t head = pos - offset;
+        Traits::copy(begin_curr + pos, begin_curr + offset, head);
+        Traits::copy(begin_curr + pos + head, begin_curr + pos + len, len - head);
+      }
       set_size(size_curr + len);
       return *this;
     }
@@ -311,7 +464,7 @@ namespace kstd
       return insert(pos, str, Traits::length(str));
     }
 
-    basic_string& insert(std::size_t pos, const basic_string& str)
+    basic_string& insert(std::size_t pos, view_type str)
     {
       return insert(pos, str.data(), str.size());
     }
@@ -327,6 +480,104 @@ namespace kstd
       return insert(pos, first, last - first);
     }
 
+    basic_string& replace(std::size_t pos, std::size_t count, const Elem* str, std::size_t len)
+    {
+      std::size_t size_curr = size();
+      if (pos > size_curr)
+        throw std::out_of_range("pos is bigger than size");
+      count = std::min(count, size_curr - pos);
+      std::size_t size_new = size_curr - count + len;
+      if (size_new > capacity() || aliases(str, len))
+      {
+        basic_string result(allocator());
+        result.reserve(size_new > capacity() ? recommended_capacity(size_new) : size_new);
+        Elem* out = result.begin();
+        Traits::copy(out, data(), pos);
+        Traits::copy(out + pos, str, len);
+        Traits::copy(out + pos + len, data() + pos + count, size_curr - pos - count + 1);
+        result.set_size(size_new);
+        return *this = std::move(result);
+      }
+      iterator begin_curr = begin();
+      Traits::move(begin_curr + pos + len, begin_curr + pos + count, size_curr - pos - count + 1);
+      Traits::copy(begin_curr + pos, str, len);
+      set_size(size_new);
+      return *this;
+    }
+
+    basic_string& replace(std::size_t pos, std::size_t count, const Elem* str)
+    {
+      return replace(pos, count, str, Traits::length(str));
+    }
+
+    basic_string& replace(std::size_t pos, std::size_t count, view_type str)
+    {
+      return replace(pos, count, str.data(), str.size());
+    }
+
+    basic_string& replace(const_iterator first, const_iterator last, view_type str)
+    {
+      return replace(first - begin(), last - first, str.data(), str.size());
+    }
+
+    std::size_t replace_all(view_type from, view_type to)
+    {
+      if (from.empty())
+        return 0;
+      if (aliases(from.data(), from.size()) || aliases(to.data(), to.size()))
+      {
+        basic_string from_copy(from, allocator());
+        basic_string to_copy(to, allocator());
+        return replace_all(view_type(from_copy), view_type(to_copy));
+      }
+      view_type str(*this);
+      std::size_t pos = str.find(from);
+      if (pos == npos)
+        return 0;
+      std::size_t count = 0;
+      std::size_t read = 0;
+      if (to.size() <= from.size())
+      {
+        iterator out = begin();
+        for (; pos != npos; pos = str.find(from, read), ++count)
+        {
+          Traits::move(out, str.data() + read, pos - read);
+          Traits::copy(out + (pos - read), to.data(), to.size());
+          out += (pos - read) + to.size();
+          read = pos + from.size();
+        }
+        Traits::move(out, str.data() + read, str.size() - read + 1);
+        set_size(out - begin() + (str.size() - read));
+        return count;
+      }
+      for (std::size_t next = pos; next != npos; next = str.find(from, next + from.size()))
+        ++count;
+      std::size_t size_new = str.size() + count * (to.size() - from.size());
+      basic_string result(allocator());
+      result.reserve(size_new > capacity() ? recommended_capacity(size_new) : size_new);
+      iterator out = result.begin();
+      for (; pos != npos; pos = str.find(from, read))
+      {
+        Traits::copy(out, str.data() + read, pos - read);
+        Traits::copy(out + (pos - read), to.data(), to.size());
+        out += (pos - read) + to.size();
+        read = pos + from.size();
+      }
+      Traits::copy(out, str.data() + read, str.size() - read + 1);
+      result.set_size(size_new);
+      *this = std::move(result);
+      return count;
+    }
+
+    std::size_t replace_all(Elem from, Elem to)
+    {
+      view_type str(*this);
+      std::size_t count = 0;
+      for (std::size_t pos = str.find(from); pos != npos; pos = str.find(from, pos + 1), ++count)
+        begin()[pos] = to;
+      return count;
+    }
+
     basic_string& assign(std::size_t sze, Elem c)
     {
       clear();
@@ -346,7 +597,14 @@ namespace kstd
 
     basic_string& assign(const Elem * str, std::size_t len)
     {
-      return *this = str;
+      assign_chars(str, len);
+      return *this;
+    }
+
+    basic_string& assign(view_type str)
+    {
+      assign_chars(str.data(), str.size());
+      return *this;
     }
 
     basic_string& assign(const Elem * str)
@@ -354,26 +612,140 @@ namespace kstd
       return *this = str;
     }
 
-    std::size_t find(const Elem * str, std::size_t offset = 0) const noexcept
+    std::size_t find(view_type str, std::size_t offset = 0) const noexcept
     {
-      std::size_t other_size = Traits::length(str);
-      std::size_t this_size = size();
-      if (offset > this_size)
-        throw std::out_of_range("pos is bigger than size");
-      for (int i = offset; i < (this_size + 1) - other_size; ++i)
-        if (std::equal(begin() + i, begin() + i + other_size, str, str + other_size))
-          return i;
-      return npos;
+      return view_type(*this).find(str, offset);
     }
 
-    std::size_t find(const basic_string & str, std::size_t offset = 0) const noexcept
+    std::size_t find(const Elem* str, std::size_t offset, std::size_t count) const noexcept
     {
-      return find(str.data(), offset);
+      return view_type(*this).find(str, offset, count);
     }
 
-    basic_string substr(std::size_t pos = 0, std::size_t sze = 0) const
+    std::size_t find(const Elem* str, std::size_t offset = 0) const noexcept
     {
-      return basic_string(begin() + pos, begin() + sze);
+      return view_type(*this).find(str, offset);
+    }
+
+    std::size_t find(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find(ch, offset);
+    }
+
+    template<typename Searcher, typename = decltype(std::declval<const Searcher&>()(std::declval<const Elem*>(), std::declval<const Elem*>()))>
+    std::size_t find(const Searcher& searcher, std::size_t offset = 0) const
+    {
+      return view_type(*this).find(searcher, offset);
+    }
+
+    std::size_t rfind(view_type str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).rfind(str, offset);
+    }
+
+    std::size_t rfind(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      return view_type(*this).rfind(str, offset, count);
+    }
+
+    std::size_t rfind(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).rfind(str, offset);
+    }
+
+    std::size_t rfind(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).rfind(ch, offset);
+    }
+
+    std::size_t find_first_of(view_type str, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_of(str, offset);
+    }
+
+    std::size_t find_first_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      return view_type(*this).find_first_of(str, offset, count);
+    }
+
+    std::size_t find_first_of(const Elem* str, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_of(str, offset);
+    }
+
+    std::size_t find_first_of(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_of(ch, offset);
+    }
+
+    std::size_t find_first_not_of(view_type str, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_not_of(str, offset);
+    }
+
+    std::size_t find_first_not_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      return view_type(*this).find_first_not_of(str, offset, count);
+    }
+
+    std::size_t find_first_not_of(const Elem* str, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_not_of(str, offset);
+    }
+
+    std::size_t find_first_not_of(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return view_type(*this).find_first_not_of(ch, offset);
+    }
+
+    std::size_t find_last_of(view_type str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_of(str, offset);
+    }
+
+    std::size_t find_last_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      return view_type(*this).find_last_of(str, offset, count);
+    }
+
+    std::size_t find_last_of(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_of(str, offset);
+    }
+
+    std::size_t find_last_of(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_of(ch, offset);
+    }
+
+    std::size_t find_last_not_of(view_type str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_not_of(str, offset);
+    }
+
+    std::size_t find_last_not_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      return view_type(*this).find_last_not_of(str, offset, count);
+    }
+
+    std::size_t find_last_not_of(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_not_of(str, offset);
+    }
+
+    std::size_t find_last_not_of(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return view_type(*this).find_last_not_of(ch, offset);
+    }
+
+    basic_string substr(std::size_t pos = 0, std::size_t count = npos) const
+    {
+      return basic_string(view_type(*this).substr(pos, count), allocator());
+    }
+
+    operator view_type() const noexcept
+    {
+      return view_type(data(), size());
     }
 
     reference operator[](std::size_t n)
@@ -386,7 +758,7 @@ namespace kstd
       return at(n);
     }
 
-    basic_string& operator+=(const basic_string & other)
+    basic_string& operator+=(view_type other)
     {
       return append(other);
     }
@@ -396,19 +768,30 @@ namespace kstd
       return append(str);
     }
 
+    template<typename Lhs, typename Rhs>
+    basic_string& operator+=(const string_concat<basic_string, Lhs, Rhs>& concat)
+    {
+      return append(concat);
+    }
+
     basic_string& operator+=(Elem ch)
     {
       return append(ch);
     }
 
-    bool operator==(const basic_string & other) const noexcept
+    bool operator==(const basic_string& other) const noexcept
+    {
+      return view_type(*this) == view_type(other);
+    }
+
+    bool operator==(view_type other) const noexcept
     {
-      return std::equal(begin(), end(), other.begin(), other.end());
+      return view_type(*this) == other;
     }
 
     bool operator==(const Elem * str) const noexcept
     {
-      return std::equal(begin(), end(), str, str + Traits::length(str));
+      return view_type(*this) == view_type(str);
     }
 
     bool operator==(Elem ch) const noexcept
@@ -416,7 +799,12 @@ namespace kstd
       return size() == 1 && *begin() == ch;
     }
 
-    bool operator!=(const basic_string & other) const noexcept
+    bool operator!=(const basic_string& other) const noexcept
+    {
+      return !(*this == other);
+    }
+
+    bool operator!=(view_type other) const noexcept
     {
       return !(*this == other);
     }
@@ -431,6 +819,56 @@ namespace kstd
       return !(*this == ch);
     }
 
+    friend void swap(basic_string& lhs, basic_string& rhs) noexcept
+    {
+      lhs.swap(rhs);
+    }
+
+    friend bool operator<(const basic_string& lhs, const basic_string& rhs) noexcept
+    {
+      return view_type(lhs).compare(rhs) < 0;
+    }
+
+    friend auto operator<=>(const basic_string& lhs, const basic_string& rhs) noexcept
+    {
+      return view_type(lhs) <=> view_type(rhs);
+    }
+
+    friend auto operator<=>(const basic_string& lhs, view_type rhs) noexcept
+    {
+      return view_type(lhs) <=> rhs;
+    }
+
+    friend auto operator<=>(const basic_string& lhs, const Elem* rhs) noexcept
+    {
+      return view_type(lhs) <=> view_type(rhs);
+    }
+
+    void swap(basic_string& other) noexcept
+    {
+      if constexpr (alloc_traits::propagate_on_container_swap::value)
+      {
+        using std::swap;
+        swap(allocator(), other.allocator());
+      }
+      std::swap(data_, other.data_);
+    }
+
+    int compare(view_type other) const noexcept
+    {
+      return view_type(*this).compare(other);
+    }
+
+    int compare(std::size_t pos, std::size_t count, view_type other) const
+    {
+      return view_type(*this).compare(pos, count, other);
+    }
+
+    int compare(const Elem* str) const noexcept
+    {
+      return view_type(*this).compare(str);
+    }
+
     Elem* data() noexcept
     {
       return on_heap() ? heap_ptr() : reinterpret_cast<Elem*>(&data_);
@@ -449,13 +887,14 @@ namespace kstd
     std::size_t size() const noexcept
     {
       if (on_heap())
-#ifdef _WIN64
-        return ((data_.long_string.size << 8) >> 8);
-#else
-        return data_.long_string.size;
-#endif
+        return layout::decode_size(data_.long_string.size);
       else
-        return 23 - (data_.short_string.size >> 1);
+        return inline_capacity - (control() >> 1);
+    }
+
+    std::size_t max_size() const noexcept
+    {
+      return std::min<std::size_t>(layout::max_size, alloc_traits::max_size(allocator()) - 1);
     }
 
     std::size_t length() const noexcept
@@ -468,7 +907,7 @@ namespace kstd
       if (on_heap())
         return data_.long_string.capacity;
       else
-        return 23;
+        return inline_capacity;
     }
 
     iterator begin() noexcept
@@ -509,32 +948,76 @@ namespace kstd
     ~basic_string()
     {
       if (on_heap())
-        delete[] data();
+        alloc_traits::deallocate(allocator(), data(), capacity() + 1);
     }
   private:
+    using basic_string::allocator_base::allocator;
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    void assign_chars(const Elem* str, std::size_t count)
+    {
+      reserve(count);
+      Traits::move(begin(), str, count);
+      data()[count] = Elem();
+      set_size(count);
+    }
+
+    bool aliases(const Elem* str, std::size_t len) const noexcept
+    {
+      std::less<const Elem*> less;
+      return len && less(str, data() + size() + 1) && less(data(), str + len);
+    }
+
+    void take(basic_string& other) noexcept
+    {
+      // neither representation points into the object itself, so it can be moved as raw bytes
+      std::memcpy(&data_, &other.data_, sizeof(data_));
+      other.set_on_heap(false);
+      other.set_size(0);
+      *other.data() = Elem();
+    }
+
+    void release() noexcept
+    {
+      if (!on_heap())
+        return;
+      alloc_traits::deallocate(allocator(), data(), capacity() + 1);
+      set_on_heap(false);
+      set_size(0);
+      *data() = Elem();
+    }
+
+    std::size_t recommended_capacity(std::size_t cap) const noexcept
+    {
+      std::size_t cap_curr = capacity();
+      return std::max(cap, cap_curr + cap_curr / 2);
+    }
+
+    void grow(std::size_t cap)
+    {
+      if (cap > capacity())
+        reserve(recommended_capacity(cap));
+    }
+
     void set_size(std::size_t value)
     {
       if (on_heap())
-#ifdef _WIN64
-        data_.long_string.size = value | (1ull << (sizeof(std::size_t) * 7));
-#else
-        data_.long_string.size = value;
-#endif
+        data_.long_string.size = layout::encode_size(value);
       else
-        data_.short_string.size = ((23 - value) << 1);
+        control() = static_cast<unsigned char>((inline_capacity - value) << 1);
     }
 
     void set_capacity(std::size_t value)
     {
       if (on_heap())
-        data_.long_string.capacity = value;
+        data_.long_string.capacity = static_cast<typename layout::word>(value);
     }
 
     void set_on_heap(bool value) noexcept
     {
       if (value == on_heap())
         return;
-      data_.short_string.size ^= 1;
+      control() ^= 1;
     }
 
     void set_heap_ptr(Elem * ptr)
@@ -544,7 +1027,17 @@ namespace kstd
 
     bool on_heap() const noexcept
     {
-      return data_.short_string.size & 1;
+      return control() & 1;
+    }
+
+    unsigned char& control() noexcept
+    {
+      return reinterpret_cast<unsigned char*>(&data_)[layout::bytes - 1];
+    }
+
+    unsigned char control() const noexcept
+    {
+      return reinterpret_cast<const unsigned char*>(&data_)[layout::bytes - 1];
     }
 
     const Elem* heap_ptr() const noexcept
@@ -559,22 +1052,100 @@ namespace kstd
 
     union
     {
-      struct
-      {
-        Elem buffer[23];
-        Elem size;
-      }
-      short_string;
-      struct
-      {
-        Elem* ptr;
-        std::size_t capacity;
-        std::size_t size;
-      }
-      long_string;
+      Elem short_string[inline_capacity + 1];
+      typename layout::heap long_string;
     }
     data_ = {};
   };
 
+  template<typename String, typename Lhs, typename Rhs>
+  class string_concat
+  {
+    using elem_type = typename String::value_type;
+    using traits_type = typename String::traits_type;
+    using concat_chars = detail::concat_chars<elem_type, traits_type>;
+    using concat_char = detail::concat_char<elem_type>;
+  public:
+    string_concat(const Lhs& lhs, const Rhs& rhs) noexcept : lhs_(lhs), rhs_(rhs), size_(lhs.size() + rhs.size()) { }
+
+    friend string_concat<String, string_concat, concat_chars> operator+(const string_concat& lhs, const String& rhs) noexcept
+    {
+      return {lhs, {rhs.data(), rhs.size()}};
+    }
+
+    friend string_concat<String, string_concat, concat_chars> operator+(const string_concat& lhs, const elem_type* rhs) noexcept
+    {
+      return {lhs, {rhs, traits_type::length(rhs)}};
+    }
+
+    friend string_concat<String, string_concat, concat_char> operator+(const string_concat& lhs, elem_type rhs) noexcept
+    {
+      return {lhs, {rhs}};
+    }
+
+    friend string_concat<String, concat_chars, string_concat> operator+(const String& lhs, const string_concat& rhs) noexcept
+    {
+      return {{lhs.data(), lhs.size()}, rhs};
+    }
+
+    friend string_concat<String, concat_chars, string_concat> operator+(const elem_type* lhs, const string_concat& rhs) noexcept
+    {
+      return {{lhs, traits_type::length(lhs)}, rhs};
+    }
+
+    friend string_concat<String, concat_char, string_concat> operator+(elem_type lhs, const string_concat& rhs) noexcept
+    {
+      return {{lhs}, rhs};
+    }
+
+    template<typename OtherLhs, typename OtherRhs>
+    friend string_concat<String, string_concat, string_concat<String, OtherLhs, OtherRhs>> operator+(const string_concat& lhs, const string_concat<String, OtherLhs, OtherRhs>& rhs) noexcept
+    {
+      return {lhs, rhs};
+    }
+
+    friend std::ostream& operator<<(std::ostream& lhs, const string_concat& rhs)
+    {
+      return lhs << String(rhs);
+    }
+
+    std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    elem_type* copy_to(elem_type* dest) const noexcept
+    {
+      return rhs_.copy_to(lhs_.copy_to(dest));
+    }
+
+    String str() const
+    {
+      return String(*this);
+    }
+  private:
+    Lhs lhs_;
+    Rhs rhs_;
+    std::size_t size_;
+  };
+
+  template<typename Elem, typename Traits, typename Allocator, std::size_t InlineCapacity>
+  struct hash<basic_string<Elem, Traits, Allocator, InlineCapacity>> : hash<basic_string_view<Elem, Traits>> { };
+
+  template<typename Elem, typename Traits, typename Allocator, std::size_t InlineCapacity>
+  struct is_trivially_relocatable<basic_string<Elem, Traits, Allocator, InlineCapacity>> : std::bool_constant<std::is_empty_v<Allocator> || is_trivially_relocatable_v<Allocator>> { };
+
+  template<typename Elem, std::size_t InlineCapacity, typename Traits = std::char_traits<Elem>, typename Allocator = caching_allocator<Elem>>
+  using basic_small_string = basic_string<Elem, Traits, Allocator, InlineCapacity>;
+
   using string = basic_string<char>;
-}
\ No newline at end of file
+
+  template<std::size_t InlineCapacity>
+  using small_string = basic_small_string<char, InlineCapacity>;
+
+  using compact_string = small_string<2 * sizeof(char*) - 1>;
+  using key_string = small_string<63>;
+}
+
+template<typename Elem, typename Traits, typename Allocator, std::size_t InlineCapacity>
+struct std::hash<kstd::basic_string<Elem, Traits, Allocator, InlineCapacity>> : kstd::hash<kstd::basic_string_view<Elem, Traits>> { };
\ No newline at end of file
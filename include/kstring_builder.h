@@ -0,0 +1,255 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include "kstring.h"
+
+namespace kstd
+{
+  template<typename Elem, typename Traits = std::char_traits<Elem>>
+  class basic_string_builder
+  {
+    struct chunk
+    {
+      chunk* next;
+      std::size_t size;
+      std::size_t capacity;
+
+      Elem* data() noexcept
+      {
+        return reinterpret_cast<Elem*>(this + 1);
+      }
+
+      const Elem* data() const noexcept
+      {
+        return reinterpret_cast<const Elem*>(this + 1);
+      }
+    };
+  public:
+    using string_type = basic_string<Elem, Traits>;
+
+    static constexpr std::size_t max_chunk_size = std::size_t(1) << 20;
+
+    struct segment
+    {
+      const Elem* data;
+      std::size_t size;
+    };
+
+    class segment_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = segment;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const segment*;
+      using reference = segment;
+
+      segment_iterator(const chunk* ptr = nullptr) noexcept : chunk_(ptr) { }
+
+      segment operator*() const noexcept
+      {
+        return {chunk_->data(), chunk_->size};
+      }
+
+      segment_iterator& operator++() noexcept
+      {
+        chunk_ = chunk_->next;
+        return *this;
+      }
+
+      segment_iterator operator++(int) noexcept
+      {
+        segment_iterator it = *this;
+        chunk_ = chunk_->next;
+        return it;
+      }
+
+      bool operator==(const segment_iterator& other) const noexcept
+      {
+        return chunk_ == other.chunk_;
+      }
+
+      bool operator!=(const segment_iterator& other) const noexcept
+      {
+        return chunk_ != other.chunk_;
+      }
+    private:
+      const chunk* chunk_;
+    };
+
+    struct segment_range
+    {
+      segment_iterator begin() const noexcept
+      {
+        return first;
+      }
+
+      segment_iterator end() const noexcept
+      {
+        return {};
+      }
+
+      segment_iterator first;
+    };
+
+    explicit basic_string_builder(std::size_t chunk_size = 256) noexcept : chunk_size_(std::max<std::size_t>(chunk_size, 16)) { }
+
+    basic_string_builder(const basic_string_builder&) = delete;
+
+    basic_string_builder(basic_string_builder&& other) noexcept : head_(other.head_), tail_(other.tail_), size_(other.size_), chunk_size_(other.chunk_size_)
+    {
+      other.head_ = nullptr;
+      other.tail_ = nullptr;
+      other.size_ = 0;
+    }
+
+    basic_string_builder& operator=(const basic_string_builder&) = delete;
+
+    basic_string_builder& operator=(basic_string_builder&& other) noexcept
+    {
+      if (this == &other)
+        return *this;
+      release(head_);
+      head_ = other.head_;
+      tail_ = other.tail_;
+      size_ = other.size_;
+      chunk_size_ = other.chunk_size_;
+      other.head_ = nullptr;
+      other.tail_ = nullptr;
+      other.size_ = 0;
+      return *this;
+    }
+
+    ~basic_string_builder()
+    {
+      release(head_);
+    }
+
+    basic_string_builder& append(const Elem* str, std::size_t len)
+    {
+      size_ += len;
+      while (len)
+      {
+        if (!tail_ || tail_->size == tail_->capacity)
+          add_chunk(len);
+        std::size_t count = std::min(len, tail_->capacity - tail_->size);
+        Traits::copy(tail_->data() + tail_->size, str, count);
+        tail_->size += count;
+        str += count;
+        len -= count;
+      }
+      return *this;
+    }
+
+    basic_string_builder& append(const Elem* str)
+    {
+      return append(str, Traits::length(str));
+    }
+
+    basic_string_builder& append(const string_type& str)
+    {
+      return append(str.data(), str.size());
+    }
+
+    basic_string_builder& append(Elem ch)
+    {
+      if (!tail_ || tail_->size == tail_->capacity)
+        add_chunk(1);
+      tail_->data()[tail_->size++] = ch;
+      ++size_;
+      return *this;
+    }
+
+    void push_back(Elem ch)
+    {
+      append(ch);
+    }
+
+    basic_string_builder& operator+=(const string_type& str)
+    {
+      return append(str);
+    }
+
+    basic_string_builder& operator+=(const Elem* str)
+    {
+      return append(str);
+    }
+
+    basic_string_builder& operator+=(Elem ch)
+    {
+      return append(ch);
+    }
+
+    std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    bool empty() const noexcept
+    {
+      return !size_;
+    }
+
+    segment_range segments() const noexcept
+    {
+      return {segment_iterator(head_)};
+    }
+
+    string_type str() const
+    {
+      string_type result;
+      result.resize_and_overwrite(size_, [this](Elem* dest, std::size_t count)
+      {
+        for (const chunk* it = head_; it; it = it->next)
+        {
+          Traits::copy(dest, it->data(), it->size);
+          dest += it->size;
+        }
+        return count;
+      });
+      return result;
+    }
+
+    void clear() noexcept
+    {
+      if (!head_)
+        return;
+      release(head_->next);
+      head_->next = nullptr;
+      head_->size = 0;
+      tail_ = head_;
+      size_ = 0;
+    }
+  private:
+    void add_chunk(std::size_t min_capacity)
+    {
+      std::size_t capacity = std::max(chunk_size_, min_capacity);
+      chunk* ptr = ::new (::operator new(sizeof(chunk) + capacity * sizeof(Elem))) chunk{nullptr, 0, capacity};
+      if (tail_)
+        tail_->next = ptr;
+      else
+        head_ = ptr;
+      tail_ = ptr;
+      chunk_size_ = std::min(chunk_size_ * 2, max_chunk_size);
+    }
+
+    static void release(chunk* ptr) noexcept
+    {
+      while (ptr)
+      {
+        chunk* next = ptr->next;
+        ::operator delete(ptr);
+        ptr = next;
+      }
+    }
+
+    chunk* head_ = nullptr;
+    chunk* tail_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t chunk_size_;
+  };
+
+  using string_builder = basic_string_builder<char>;
+}
@@ -0,0 +1,313 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include "kvector.h"
+#include "kstring_view.h"
+
+namespace kstd
+{
+  template<typename Elem, typename Traits = std::char_traits<Elem>, typename Offset = std::uint32_t>
+  class basic_string_column
+  {
+  public:
+    using value_type = basic_string_view<Elem, Traits>;
+    using view_type = value_type;
+    using offset_type = Offset;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = view_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = view_type;
+
+      friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ == rhs.index_;
+      }
+
+      friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ != rhs.index_;
+      }
+
+      friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ < rhs.index_;
+      }
+
+      friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ > rhs.index_;
+      }
+
+      friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ <= rhs.index_;
+      }
+
+      friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return lhs.index_ >= rhs.index_;
+      }
+
+      friend const_iterator operator+(const_iterator it, difference_type n) noexcept
+      {
+        return it += n;
+      }
+
+      friend const_iterator operator+(difference_type n, const_iterator it) noexcept
+      {
+        return it += n;
+      }
+
+      friend const_iterator operator-(const_iterator it, difference_type n) noexcept
+      {
+        return it -= n;
+      }
+
+      friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept
+      {
+        return difference_type(lhs.index_) - difference_type(rhs.index_);
+      }
+
+      const_iterator() = default;
+
+      view_type operator*() const noexcept
+      {
+        return (*column_)[index_];
+      }
+
+      view_type operator[](difference_type n) const noexcept
+      {
+        return (*column_)[index_ + n];
+      }
+
+      const_iterator& operator++() noexcept
+      {
+        ++index_;
+        return *this;
+      }
+
+      const_iterator operator++(int) noexcept
+      {
+        const_iterator result = *this;
+        ++index_;
+        return result;
+      }
+
+      const_iterator& operator--() noexcept
+      {
+        --index_;
+        return *this;
+      }
+
+      const_iterator operator--(int) noexcept
+      {
+        const_iterator result = *this;
+        --index_;
+        return result;
+      }
+
+      const_iterator& operator+=(difference_type n) noexcept
+      {
+        index_ += n;
+        return *this;
+      }
+
+      const_iterator& operator-=(difference_type n) noexcept
+      {
+        index_ -= n;
+        return *this;
+      }
+    private:
+      friend class basic_string_column;
+
+      const_iterator(const basic_string_column* column, size_type index) noexcept : column_(column), index_(index) { }
+
+      const basic_string_column* column_ = nullptr;
+      size_type index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    basic_string_column()
+    {
+      offsets_.push_back(0);
+    }
+
+    // capacity
+
+    size_type size() const noexcept
+    {
+      return offsets_.size() - 1;
+    }
+
+    bool empty() const noexcept
+    {
+      return !size();
+    }
+
+    size_type data_size() const noexcept
+    {
+      return bytes_.size();
+    }
+
+    void reserve(size_type rows, size_type bytes)
+    {
+      offsets_.reserve(rows + 1);
+      bytes_.reserve(bytes);
+    }
+
+    // element access
+
+    view_type operator[](size_type n) const noexcept
+    {
+      return view_type(bytes_.data() + offsets_[n], offsets_[n + 1] - offsets_[n]);
+    }
+
+    view_type at(size_type n) const
+    {
+      if (n >= size())
+        throw std::out_of_range("n is out of range");
+      return (*this)[n];
+    }
+
+    view_type front() const noexcept
+    {
+      return (*this)[0];
+    }
+
+    view_type back() const noexcept
+    {
+      return (*this)[size() - 1];
+    }
+
+    const Elem* data() const noexcept
+    {
+      return bytes_.data();
+    }
+
+    const Offset* offsets() const noexcept
+    {
+      return offsets_.data();
+    }
+
+    const_iterator begin() const noexcept
+    {
+      return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+      return const_iterator(this, size());
+    }
+
+    // modifiers
+
+    void push_back(view_type str)
+    {
+      size_type size_curr = bytes_.size();
+      if (str.size() > std::numeric_limits<Offset>::max() - size_curr)
+        throw std::length_error("string_column offsets overflow");
+      // str may be a row of this column, so it is found again by offset once bytes_ has grown
+      bool inside = aliases(str);
+      size_type offset = inside ? str.data() - bytes_.data() : 0;
+      bytes_.resize(size_curr + str.size());
+      Traits::copy(bytes_.data() + size_curr, inside ? bytes_.data() + offset : str.data(), str.size());
+      offsets_.push_back(static_cast<Offset>(bytes_.size()));
+    }
+
+    template<typename InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+      for (; first != last; ++first)
+        push_back(view_type(*first));
+    }
+
+    void pop_back()
+    {
+      offsets_.pop_back();
+      bytes_.resize(offsets_.back());
+    }
+
+    void clear() noexcept
+    {
+      bytes_.clear();
+      offsets_.resize(1);
+    }
+
+    // bulk operations
+
+    template<typename Function>
+    void for_each(Function f) const
+    {
+      const Elem* bytes = bytes_.data();
+      const Offset* offsets = offsets_.data();
+      for (size_type i = 0, n = size(); i < n; ++i)
+        f(view_type(bytes + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+
+    template<typename Predicate>
+    size_type count_if(Predicate pred) const
+    {
+      size_type count = 0;
+      for_each([&](view_type str) { count += bool(pred(str)); });
+      return count;
+    }
+
+    template<typename Predicate>
+    vector<size_type> select(Predicate pred) const
+    {
+      vector<size_type> result;
+      size_type index = 0;
+      for_each([&](view_type str)
+      {
+        if (pred(str))
+          result.push_back(index);
+        ++index;
+      });
+      return result;
+    }
+
+    template<typename Predicate>
+    basic_string_column filter(Predicate pred) const
+    {
+      basic_string_column result;
+      for_each([&](view_type str)
+      {
+        if (pred(str))
+          result.push_back(str);
+      });
+      return result;
+    }
+
+    size_type find(view_type str) const noexcept
+    {
+      const Offset* offsets = offsets_.data();
+      for (size_type i = 0, n = size(); i < n; ++i)
+        if (offsets[i + 1] - offsets[i] == str.size() && (*this)[i] == str)
+          return i;
+      return view_type::npos;
+    }
+  private:
+    bool aliases(view_type str) const noexcept
+    {
+      std::less<const Elem*> less;
+      return !str.empty() && less(str.data(), bytes_.data() + bytes_.size()) && less(bytes_.data(), str.data() + str.size());
+    }
+
+    vector<Elem> bytes_;
+    vector<Offset> offsets_;
+  };
+
+  using string_column = basic_string_column<char>;
+}
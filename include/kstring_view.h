@@ -0,0 +1,518 @@
+#pragma once
+#include <cstring>
+#include <compare>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "ksimd.h"
+#include "kfunctional.h"
+
+namespace kstd
+{
+  template<typename T>
+  struct char_traits { };
+
+  template<>
+  struct char_traits<char>
+  {
+    using char_type = char;
+    using int_type = int;
+    using off_type = std::size_t;
+    using pos_type = std::size_t;
+    using comparison_category = std::strong_ordering;
+
+    static constexpr std::size_t length(const char_type* str)
+    {
+      return std::strlen(str);
+    }
+
+    static constexpr void copy(char_type* dest, const char_type* src, std::size_t count)
+    {
+      std::copy(src, src + count, dest);
+    }
+
+    static constexpr void move(char_type* dest, const char_type* src, std::size_t count)
+    {
+      std::memmove(dest, src, count);
+    }
+
+    static constexpr void assign(char_type& dest, const char_type& src) noexcept
+    {
+      dest = src;
+    }
+
+    static constexpr bool eq(char_type lhs, char_type rhs) noexcept
+    {
+      return lhs == rhs;
+    }
+
+    static constexpr bool lt(char_type lhs, char_type rhs) noexcept
+    {
+      return static_cast<unsigned char>(lhs) < static_cast<unsigned char>(rhs);
+    }
+
+    static constexpr int compare(const char_type* lhs, const char_type* rhs, std::size_t count)
+    {
+      return std::memcmp(lhs, rhs, count);
+    }
+
+    static const char_type* find(const char_type* str, std::size_t count, const char_type& ch)
+    {
+      return static_cast<const char_type*>(std::memchr(str, ch, count));
+    }
+  };
+
+  namespace detail
+  {
+    template<typename Traits, typename = void>
+    struct comparison_category
+    {
+      using type = std::weak_ordering;
+    };
+
+    template<typename Traits>
+    struct comparison_category<Traits, std::void_t<typename Traits::comparison_category>>
+    {
+      using type = typename Traits::comparison_category;
+    };
+
+    template<typename Traits>
+    using comparison_category_t = typename comparison_category<Traits>::type;
+
+    template<typename Elem, typename Traits>
+    constexpr bool has_byte_search_v = sizeof(Elem) == 1 && std::is_integral_v<Elem> &&
+      (std::is_same_v<Traits, std::char_traits<Elem>> || std::is_same_v<Traits, kstd::char_traits<Elem>>);
+
+    template<typename Elem, typename Traits>
+    std::size_t string_find(const Elem* str, std::size_t size, const Elem* needle, std::size_t count) noexcept
+    {
+      if constexpr (has_byte_search_v<Elem, Traits>)
+      {
+        return byte_search().find(reinterpret_cast<const char*>(str), size, reinterpret_cast<const char*>(needle), count);
+      }
+      else
+      {
+        if (count > size)
+          return simd_npos;
+        for (std::size_t i = 0; i <= size - count; ++i)
+          if (!Traits::compare(str + i, needle, count))
+            return i;
+        return simd_npos;
+      }
+    }
+
+    template<typename Elem, typename Traits>
+    std::size_t string_rfind(const Elem* str, std::size_t size, const Elem* needle, std::size_t count) noexcept
+    {
+      if constexpr (has_byte_search_v<Elem, Traits>)
+      {
+        return byte_search().rfind(reinterpret_cast<const char*>(str), size, reinterpret_cast<const char*>(needle), count);
+      }
+      else
+      {
+        if (count > size)
+          return simd_npos;
+        for (std::size_t i = size - count + 1; i-- > 0;)
+          if (!Traits::compare(str + i, needle, count))
+            return i;
+        return simd_npos;
+      }
+    }
+
+    template<typename Elem, typename Traits, bool Negate>
+    std::size_t string_find_first_of(const Elem* str, std::size_t size, const Elem* set, std::size_t count) noexcept
+    {
+      if constexpr (has_byte_search_v<Elem, Traits>)
+      {
+        const byte_search_kernels& kernels = byte_search();
+        return (Negate ? kernels.find_first_not_of : kernels.find_first_of)(reinterpret_cast<const char*>(str), size, reinterpret_cast<const char*>(set), count);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < size; ++i)
+          if ((Traits::find(set, count, str[i]) != nullptr) != Negate)
+            return i;
+        return simd_npos;
+      }
+    }
+
+    template<typename Elem, typename Traits, bool Negate>
+    std::size_t string_find_last_of(const Elem* str, std::size_t size, const Elem* set, std::size_t count) noexcept
+    {
+      if constexpr (has_byte_search_v<Elem, Traits>)
+      {
+        byte_set bits(reinterpret_cast<const char*>(set), count);
+        for (std::size_t i = size; i-- > 0;)
+          if (bits.contains(static_cast<char>(str[i])) != Negate)
+            return i;
+        return simd_npos;
+      }
+      else
+      {
+        for (std::size_t i = size; i-- > 0;)
+          if ((Traits::find(set, count, str[i]) != nullptr) != Negate)
+            return i;
+        return simd_npos;
+      }
+    }
+  }
+
+  template<typename Elem, typename Traits = std::char_traits<Elem>>
+  class basic_string_view
+  {
+  public:
+    static constexpr std::size_t npos = -1;
+    using value_type = Elem;
+    using traits_type = Traits;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Elem*;
+    using const_pointer = const Elem*;
+    using reference = Elem&;
+    using const_reference = const Elem&;
+    using iterator = const Elem*;
+    using const_iterator = const Elem*;
+
+    friend bool operator==(basic_string_view lhs, basic_string_view rhs) noexcept
+    {
+      return lhs.size_ == rhs.size_ && !Traits::compare(lhs.data_, rhs.data_, lhs.size_);
+    }
+
+    friend bool operator!=(basic_string_view lhs, basic_string_view rhs) noexcept
+    {
+      return !(lhs == rhs);
+    }
+
+    friend bool operator<(basic_string_view lhs, basic_string_view rhs) noexcept
+    {
+      return lhs.compare(rhs) < 0;
+    }
+
+    friend detail::comparison_category_t<Traits> operator<=>(basic_string_view lhs, basic_string_view rhs) noexcept
+    {
+      return static_cast<detail::comparison_category_t<Traits>>(lhs.compare(rhs) <=> 0);
+    }
+
+    friend std::basic_ostream<Elem>& operator<<(std::basic_ostream<Elem>& lhs, basic_string_view rhs)
+    {
+      lhs.write(rhs.data_, rhs.size_);
+      return lhs;
+    }
+
+    constexpr basic_string_view() noexcept = default;
+
+    constexpr basic_string_view(const Elem* str, std::size_t count) noexcept : data_(str), size_(count) { }
+
+    constexpr basic_string_view(const Elem* str) noexcept : data_(str), size_(Traits::length(str)) { }
+
+    constexpr basic_string_view(const_iterator first, const_iterator last) noexcept : data_(first), size_(last - first) { }
+
+    constexpr const_iterator begin() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr const_iterator end() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr const_iterator cend() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    constexpr const_reference operator[](std::size_t n) const noexcept
+    {
+      return data_[n];
+    }
+
+    constexpr const_reference at(std::size_t n) const
+    {
+      if (n >= size_)
+        throw std::out_of_range("n is out of range");
+      return data_[n];
+    }
+
+    constexpr const_reference front() const noexcept
+    {
+      return *data_;
+    }
+
+    constexpr const_reference back() const noexcept
+    {
+      return data_[size_ - 1];
+    }
+
+    constexpr const Elem* data() const noexcept
+    {
+      return data_;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    constexpr std::size_t length() const noexcept
+    {
+      return size_;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+      return !size_;
+    }
+
+    constexpr void remove_prefix(std::size_t n) noexcept
+    {
+      data_ += n;
+      size_ -= n;
+    }
+
+    constexpr void remove_suffix(std::size_t n) noexcept
+    {
+      size_ -= n;
+    }
+
+    constexpr basic_string_view substr(std::size_t pos = 0, std::size_t count = npos) const
+    {
+      if (pos > size_)
+        throw std::out_of_range("pos is bigger than size");
+      return {data_ + pos, std::min(count, size_ - pos)};
+    }
+
+    int compare(basic_string_view other) const noexcept
+    {
+      int result = Traits::compare(data_, other.data_, std::min(size_, other.size_));
+      if (result)
+        return result;
+      return size_ < other.size_ ? -1 : size_ != other.size_;
+    }
+
+    int compare(std::size_t pos, std::size_t count, basic_string_view other) const
+    {
+      return substr(pos, count).compare(other);
+    }
+
+    int compare(const Elem* str) const noexcept
+    {
+      return compare(basic_string_view(str));
+    }
+
+    bool starts_with(basic_string_view str) const noexcept
+    {
+      return size_ >= str.size_ && !Traits::compare(data_, str.data_, str.size_);
+    }
+
+    bool starts_with(Elem ch) const noexcept
+    {
+      return size_ && Traits::eq(*data_, ch);
+    }
+
+    bool ends_with(basic_string_view str) const noexcept
+    {
+      return size_ >= str.size_ && !Traits::compare(data_ + size_ - str.size_, str.data_, str.size_);
+    }
+
+    bool ends_with(Elem ch) const noexcept
+    {
+      return size_ && Traits::eq(data_[size_ - 1], ch);
+    }
+
+    bool contains(basic_string_view str) const noexcept
+    {
+      return find(str) != npos;
+    }
+
+    bool contains(Elem ch) const noexcept
+    {
+      return find(ch) != npos;
+    }
+
+    std::size_t find(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (offset > size_)
+        return npos;
+      std::size_t pos = detail::string_find<Elem, Traits>(data_ + offset, size_ - offset, str, count);
+      return pos == npos ? npos : pos + offset;
+    }
+
+    std::size_t find(basic_string_view str, std::size_t offset = 0) const noexcept
+    {
+      return find(str.data_, offset, str.size_);
+    }
+
+    std::size_t find(const Elem* str, std::size_t offset = 0) const noexcept
+    {
+      return find(str, offset, Traits::length(str));
+    }
+
+    std::size_t find(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return find(&ch, offset, 1);
+    }
+
+    template<typename Searcher, typename = decltype(std::declval<const Searcher&>()(std::declval<const Elem*>(), std::declval<const Elem*>()))>
+    std::size_t find(const Searcher& searcher, std::size_t offset = 0) const
+    {
+      if (offset > size_)
+        return npos;
+      const_iterator last = end();
+      const_iterator pos = searcher(data_ + offset, last).first;
+      return pos == last ? npos : pos - data_;
+    }
+
+    std::size_t rfind(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (count > size_)
+        return npos;
+      std::size_t last = std::min(offset, size_ - count);
+      return detail::string_rfind<Elem, Traits>(data_, last + count, str, count);
+    }
+
+    std::size_t rfind(basic_string_view str, std::size_t offset = npos) const noexcept
+    {
+      return rfind(str.data_, offset, str.size_);
+    }
+
+    std::size_t rfind(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return rfind(str, offset, Traits::length(str));
+    }
+
+    std::size_t rfind(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return rfind(&ch, offset, 1);
+    }
+
+    std::size_t find_first_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (offset >= size_)
+        return npos;
+      std::size_t pos = detail::string_find_first_of<Elem, Traits, false>(data_ + offset, size_ - offset, str, count);
+      return pos == npos ? npos : pos + offset;
+    }
+
+    std::size_t find_first_of(basic_string_view str, std::size_t offset = 0) const noexcept
+    {
+      return find_first_of(str.data_, offset, str.size_);
+    }
+
+    std::size_t find_first_of(const Elem* str, std::size_t offset = 0) const noexcept
+    {
+      return find_first_of(str, offset, Traits::length(str));
+    }
+
+    std::size_t find_first_of(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return find(&ch, offset, 1);
+    }
+
+    std::size_t find_first_not_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (offset >= size_)
+        return npos;
+      std::size_t pos = detail::string_find_first_of<Elem, Traits, true>(data_ + offset, size_ - offset, str, count);
+      return pos == npos ? npos : pos + offset;
+    }
+
+    std::size_t find_first_not_of(basic_string_view str, std::size_t offset = 0) const noexcept
+    {
+      return find_first_not_of(str.data_, offset, str.size_);
+    }
+
+    std::size_t find_first_not_of(const Elem* str, std::size_t offset = 0) const noexcept
+    {
+      return find_first_not_of(str, offset, Traits::length(str));
+    }
+
+    std::size_t find_first_not_of(Elem ch, std::size_t offset = 0) const noexcept
+    {
+      return find_first_not_of(&ch, offset, 1);
+    }
+
+    std::size_t find_last_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (!size_)
+        return npos;
+      return detail::string_find_last_of<Elem, Traits, false>(data_, std::min(offset, size_ - 1) + 1, str, count);
+    }
+
+    std::size_t find_last_of(basic_string_view str, std::size_t offset = npos) const noexcept
+    {
+      return find_last_of(str.data_, offset, str.size_);
+    }
+
+    std::size_t find_last_of(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return find_last_of(str, offset, Traits::length(str));
+    }
+
+    std::size_t find_last_of(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return rfind(&ch, offset, 1);
+    }
+
+    std::size_t find_last_not_of(const Elem* str, std::size_t offset, std::size_t count) const noexcept
+    {
+      if (!size_)
+        return npos;
+      return detail::string_find_last_of<Elem, Traits, true>(data_, std::min(offset, size_ - 1) + 1, str, count);
+    }
+
+    std::size_t find_last_not_of(basic_string_view str, std::size_t offset = npos) const noexcept
+    {
+      return find_last_not_of(str.data_, offset, str.size_);
+    }
+
+    std::size_t find_last_not_of(const Elem* str, std::size_t offset = npos) const noexcept
+    {
+      return find_last_not_of(str, offset, Traits::length(str));
+    }
+
+    std::size_t find_last_not_of(Elem ch, std::size_t offset = npos) const noexcept
+    {
+      return find_last_not_of(&ch, offset, 1);
+    }
+  private:
+    const Elem* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+
+  template<typename Elem, typename Traits>
+  struct hash<basic_string_view<Elem, Traits>>
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(basic_string_view<Elem, Traits> str) const noexcept
+    {
+      return static_cast<std::size_t>(hash_bytes(str.data(), str.size() * sizeof(Elem)));
+    }
+  };
+
+  using string_view = basic_string_view<char>;
+
+  inline bool iequals(string_view lhs, string_view rhs) noexcept
+  {
+    return lhs.size() == rhs.size() && detail::mismatch_ifold()(lhs.data(), rhs.data(), lhs.size()) == detail::simd_npos;
+  }
+
+  inline int icompare(string_view lhs, string_view rhs) noexcept
+  {
+    std::size_t pos = detail::mismatch_ifold()(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+    if (pos != detail::simd_npos)
+      return detail::ascii_fold(lhs[pos]) < detail::ascii_fold(rhs[pos]) ? -1 : 1;
+    return lhs.size() < rhs.size() ? -1 : lhs.size() != rhs.size();
+  }
+}
+
+template<typename Elem, typename Traits>
+struct std::hash<kstd::basic_string_view<Elem, Traits>> : kstd::hash<kstd::basic_string_view<Elem, Traits>> { };
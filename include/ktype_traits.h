@@ -1,17 +1,32 @@
 #pragma once
 #include <iterator>
+#include <memory>
+#include <type_traits>
 
 namespace kstd
 {
+  // opt-in: T may be moved to a new address with memcpy, ending the lifetime of the source without running its destructor
+  template<typename T>
+  struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> { };
+
+  template<typename T, typename Deleter>
+  struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : std::bool_constant<std::is_empty_v<Deleter> || is_trivially_relocatable<Deleter>::value> { };
+
+  template<typename T>
+  constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
   namespace detail
   {
     template<class, class = void>
     struct is_iterator : std::false_type { };
 
     template<class T>
-    struct is_iterator<T, decltype(std::iterator_traits<T>::iterator_category(), void())> : std::true_type { };
+    struct is_iterator<T, decltype(typename std::iterator_traits<T>::iterator_category(), void())> : std::true_type { };
 
     template<typename T>
     constexpr bool is_iterator_v = is_iterator<T>::value;
+
+    template<typename T>
+    constexpr bool is_forward_iterator_v = std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<T>::iterator_category>;
   }
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "ksimd.h"
+#include "kstring.h"
+
+namespace kstd
+{
+  namespace detail
+  {
+    inline bool utf8_ascii_8(const unsigned char* ptr) noexcept
+    {
+      std::uint64_t value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return !(value & 0x8080808080808080ull);
+    }
+
+    inline bool validate_utf8_scalar(const char* str, std::size_t size) noexcept
+    {
+      const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str);
+      const unsigned char* end = ptr + size;
+      while (ptr != end)
+      {
+        if (end - ptr >= 8 && utf8_ascii_8(ptr))
+        {
+          ptr += 8;
+          continue;
+        }
+        unsigned char lead = *ptr;
+        if (lead < 0x80)
+        {
+          ++ptr;
+          continue;
+        }
+        std::size_t len = 0;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+          len = 2;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+          len = 3;
+          if (lead == 0xE0)
+            lo = 0xA0;
+          else if (lead == 0xED)
+            hi = 0x9F;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+          len = 4;
+          if (lead == 0xF0)
+            lo = 0x90;
+          else if (lead == 0xF4)
+            hi = 0x8F;
+        }
+        else
+        {
+          return false;
+        }
+        if (std::size_t(end - ptr) < len || ptr[1] < lo || ptr[1] > hi)
+          return false;
+        for (std::size_t i = 2; i < len; ++i)
+          if ((ptr[i] & 0xC0) != 0x80)
+            return false;
+        ptr += len;
+      }
+      return true;
+    }
+
+#ifdef KSTD_SIMD_X64
+    // keiser-lemire lookup tables, indexed by nibble
+
+    alignas(16) constexpr unsigned char utf8_byte_1_high[16] =
+    {
+      0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+      0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+    };
+
+    alignas(16) constexpr unsigned char utf8_byte_1_low[16] =
+    {
+      0xE7, 0xA3, 0x83, 0x83, 0x8B, 0xCB, 0xCB, 0xCB,
+      0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xDB, 0xCB, 0xCB
+    };
+
+    alignas(16) constexpr unsigned char utf8_byte_2_high[16] =
+    {
+      0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+      0xE6, 0xAE, 0xBA, 0xBA, 0x01, 0x01, 0x01, 0x01
+    };
+
+    alignas(32) constexpr unsigned char utf8_incomplete_max[32] =
+    {
+      0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+      0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+    };
+
+    struct utf8_state_sse42
+    {
+      __m128i error;
+      __m128i prev_input;
+      __m128i prev_incomplete;
+    };
+
+    KSTD_TARGET_SSE42 inline void validate_utf8_block_sse42(utf8_state_sse42& state, __m128i input) noexcept
+    {
+      if (!_mm_movemask_epi8(input))
+      {
+        state.error = _mm_or_si128(state.error, state.prev_incomplete);
+        state.prev_input = input;
+        return;
+      }
+      const __m128i low_nibble = _mm_set1_epi8(0x0F);
+      __m128i prev_1 = _mm_alignr_epi8(input, state.prev_input, 15);
+      __m128i prev_2 = _mm_alignr_epi8(input, state.prev_input, 14);
+      __m128i prev_3 = _mm_alignr_epi8(input, state.prev_input, 13);
+      __m128i byte_1_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high)), _mm_and_si128(_mm_srli_epi16(prev_1, 4), low_nibble));
+      __m128i byte_1_low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low)), _mm_and_si128(prev_1, low_nibble));
+      __m128i byte_2_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high)), _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+      __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+      __m128i third = _mm_subs_epu8(prev_2, _mm_set1_epi8(char(0xE0 - 0x80)));
+      __m128i fourth = _mm_subs_epu8(prev_3, _mm_set1_epi8(char(0xF0 - 0x80)));
+      __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+      state.error = _mm_or_si128(state.error, _mm_xor_si128(must_continue, special));
+      state.prev_incomplete = _mm_subs_epu8(input, _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_incomplete_max + 16)));
+      state.prev_input = input;
+    }
+
+    KSTD_TARGET_SSE42 inline bool validate_utf8_sse42(const char* str, std::size_t size) noexcept
+    {
+      utf8_state_sse42 state = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+      std::size_t i = 0;
+      for (; i + 16 <= size; i += 16)
+        validate_utf8_block_sse42(state, _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)));
+      char tail[16] = {};
+      std::memcpy(tail, str + i, size - i);
+      validate_utf8_block_sse42(state, _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)));
+      return _mm_testz_si128(state.error, state.error);
+    }
+
+    struct utf8_state_avx2
+    {
+      __m256i error;
+      __m256i prev_input;
+      __m256i prev_incomplete;
+    };
+
+    KSTD_TARGET_AVX2 inline __m256i utf8_table_avx2(const unsigned char* table) noexcept
+    {
+      return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+    }
+
+    KSTD_TARGET_AVX2 inline void validate_utf8_block_avx2(utf8_state_avx2& state, __m256i input) noexcept
+    {
+      if (!_mm256_movemask_epi8(input))
+      {
+        state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+        state.prev_input = input;
+        return;
+      }
+      const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+      __m256i shifted = _mm256_permute2x128_si256(state.prev_input, input, 0x21);
+      __m256i prev_1 = _mm256_alignr_epi8(input, shifted, 15);
+      __m256i prev_2 = _mm256_alignr_epi8(input, shifted, 14);
+      __m256i prev_3 = _mm256_alignr_epi8(input, shifted, 13);
+      __m256i byte_1_high = _mm256_shuffle_epi8(utf8_table_avx2(utf8_byte_1_high), _mm256_and_si256(_mm256_srli_epi16(prev_1, 4), low_nibble));
+      __m256i byte_1_low = _mm256_shuffle_epi8(utf8_table_avx2(utf8_byte_1_low), _mm256_and_si256(prev_1, low_nibble));
+      __m256i byte_2_high = _mm256_shuffle_epi8(utf8_table_avx2(utf8_byte_2_high), _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+      __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+      __m256i third = _mm256_subs_epu8(prev_2, _mm256_set1_epi8(char(0xE0 - 0x80)));
+      __m256i fourth = _mm256_subs_epu8(prev_3, _mm256_set1_epi8(char(0xF0 - 0x80)));
+      __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+      state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_continue, special));
+      state.prev_incomplete = _mm256_subs_epu8(input, _mm256_load_si256(reinterpret_cast<const __m256i*>(utf8_incomplete_max)));
+      state.prev_input = input;
+    }
+
+    KSTD_TARGET_AVX2 inline bool validate_utf8_avx2(const char* str, std::size_t size) noexcept
+    {
+      utf8_state_avx2 state = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+      std::size_t i = 0;
+      for (; i + 32 <= size; i += 32)
+        validate_utf8_block_avx2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i)));
+      char tail[32] = {};
+      std::memcpy(tail, str + i, size - i);
+      validate_utf8_block_avx2(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail)));
+      return _mm256_testz_si256(state.error, state.error);
+    }
+#endif
+
+    using utf8_validate_fn = bool(*)(const char*, std::size_t) noexcept;
+
+    inline utf8_validate_fn select_utf8_validator() noexcept
+    {
+#ifdef KSTD_SIMD_X64
+      if (cpu().avx2)
+        return validate_utf8_avx2;
+      if (cpu().sse42)
+        return validate_utf8_sse42;
+#endif
+      return validate_utf8_scalar;
+    }
+
+    inline utf8_validate_fn utf8_validator() noexcept
+    {
+      static const utf8_validate_fn validator = select_utf8_validator();
+      return validator;
+    }
+
+    template<typename Char>
+    std::size_t utf8_decode(const char* str, std::size_t size, Char* out) noexcept
+    {
+      const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str);
+      const unsigned char* end = ptr + size;
+      Char* begin = out;
+      while (ptr != end)
+      {
+        if (end - ptr >= 8 && utf8_ascii_8(ptr))
+        {
+          for (std::size_t i = 0; i < 8; ++i)
+            out[i] = ptr[i];
+          ptr += 8;
+          out += 8;
+          continue;
+        }
+        char32_t code = *ptr;
+        if (code < 0x80)
+        {
+          ++ptr;
+        }
+        else if (code < 0xE0)
+        {
+          code = ((code & 0x1F) << 6) | (ptr[1] & 0x3F);
+          ptr += 2;
+        }
+        else if (code < 0xF0)
+        {
+          code = ((code & 0x0F) << 12) | ((ptr[1] & 0x3F) << 6) | (ptr[2] & 0x3F);
+          ptr += 3;
+        }
+        else
+        {
+          code = ((code & 0x07) << 18) | ((ptr[1] & 0x3F) << 12) | ((ptr[2] & 0x3F) << 6) | (ptr[3] & 0x3F);
+          ptr += 4;
+        }
+        if (sizeof(Char) == 2 && code > 0xFFFF)
+        {
+          code -= 0x10000;
+          *out++ = Char(0xD800 + (code >> 10));
+          *out++ = Char(0xDC00 + (code & 0x3FF));
+        }
+        else
+        {
+          *out++ = Char(code);
+        }
+      }
+      return out - begin;
+    }
+
+    inline std::size_t utf8_encoded_length(char32_t code) noexcept
+    {
+      return code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+    }
+
+    inline char* utf8_encode(char32_t code, char* out) noexcept
+    {
+      if (code < 0x80)
+      {
+        *out++ = char(code);
+      }
+      else if (code < 0x800)
+      {
+        *out++ = char(0xC0 | (code >> 6));
+        *out++ = char(0x80 | (code & 0x3F));
+      }
+      else if (code < 0x10000)
+      {
+        *out++ = char(0xE0 | (code >> 12));
+        *out++ = char(0x80 | ((code >> 6) & 0x3F));
+        *out++ = char(0x80 | (code & 0x3F));
+      }
+      else
+      {
+        *out++ = char(0xF0 | (code >> 18));
+        *out++ = char(0x80 | ((code >> 12) & 0x3F));
+        *out++ = char(0x80 | ((code >> 6) & 0x3F));
+        *out++ = char(0x80 | (code & 0x3F));
+      }
+      return out;
+    }
+
+    inline char32_t utf16_next(const char16_t*& ptr, const char16_t* end)
+    {
+      char32_t code = *ptr++;
+      if (code < 0xD800 || code > 0xDFFF)
+        return code;
+      if (code > 0xDBFF || ptr == end || *ptr < 0xDC00 || *ptr > 0xDFFF)
+        throw std::range_error("invalid UTF-16");
+      return 0x10000 + ((code - 0xD800) << 10) + (*ptr++ - 0xDC00);
+    }
+  }
+
+  namespace utf8
+  {
+    inline bool validate(const char* str, std::size_t size) noexcept
+    {
+      return detail::utf8_validator()(str, size);
+    }
+
+    inline bool validate(string_view str) noexcept
+    {
+      return validate(str.data(), str.size());
+    }
+
+    inline std::size_t utf16_length(string_view str) noexcept
+    {
+      std::size_t count = 0;
+      for (char ch : str)
+        count += ((ch & 0xC0) != 0x80) + (static_cast<unsigned char>(ch) >= 0xF0);
+      return count;
+    }
+
+    inline std::size_t utf32_length(string_view str) noexcept
+    {
+      std::size_t count = 0;
+      for (char ch : str)
+        count += (ch & 0xC0) != 0x80;
+      return count;
+    }
+
+    inline basic_string<char16_t> to_utf16(string_view str)
+    {
+      if (!validate(str))
+        throw std::range_error("invalid UTF-8");
+      basic_string<char16_t> result;
+      result.resize_and_overwrite(utf16_length(str), [&](char16_t* out, std::size_t)
+      {
+        return detail::utf8_decode(str.data(), str.size(), out);
+      });
+      return result;
+    }
+
+    inline basic_string<char32_t> to_utf32(string_view str)
+    {
+      if (!validate(str))
+        throw std::range_error("invalid UTF-8");
+      basic_string<char32_t> result;
+      result.resize_and_overwrite(utf32_length(str), [&](char32_t* out, std::size_t)
+      {
+        return detail::utf8_decode(str.data(), str.size(), out);
+      });
+      return result;
+    }
+
+    inline string from_utf16(basic_string_view<char16_t> str)
+    {
+      std::size_t count = 0;
+      for (const char16_t* ptr = str.data(), *end = ptr + str.size(); ptr != end;)
+        count += detail::utf8_encoded_length(detail::utf16_next(ptr, end));
+      string result;
+      result.resize_and_overwrite(count, [&](char* out, std::size_t)
+      {
+        char* begin = out;
+        for (const char16_t* ptr = str.data(), *end = ptr + str.size(); ptr != end;)
+          out = detail::utf8_encode(detail::utf16_next(ptr, end), out);
+        return std::size_t(out - begin);
+      });
+      return result;
+    }
+
+    inline string from_utf32(basic_string_view<char32_t> str)
+    {
+      std::size_t count = 0;
+      for (char32_t code : str)
+      {
+        if (code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+          throw std::range_error("invalid UTF-32");
+        count += detail::utf8_encoded_length(code);
+      }
+      string result;
+      result.resize_and_overwrite(count, [&](char* out, std::size_t)
+      {
+        char* begin = out;
+        for (char32_t code : str)
+          out = detail::utf8_encode(code, out);
+        return std::size_t(out - begin);
+      });
+      return result;
+    }
+  }
+}
@@ -3,6 +3,8 @@
 #include <utility>
 #include <type_traits>
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
 #include "kmemory.h"
 #include "ktype_traits.h"
 
@@ -12,87 +14,10 @@ namespace kstd
   {
 #define ALLOW_UB
 
-    template<typename Allocator, typename = void>
-    struct allocator_base
-    {
-    public:
-      allocator_base() noexcept(noexcept(Allocator())) : allocator_(Allocator()) { }
-
-      allocator_base(const Allocator& alloc) noexcept : allocator_(traits::select_on_container_copy_construction(alloc)) { }
-
-      allocator_base(Allocator&& alloc) noexcept : allocator_(std::move(alloc)) { }
-
-      allocator_base operator=(const Allocator& alloc)
-      {
-        if constexpr (traits::propagate_on_container_copy_assignment::value)
-          allocator() = alloc;
-        return *this;
-      }
-
-      allocator_base operator=(Allocator&& alloc) noexcept(traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value)
-      {
-        if constexpr (traits::propagate_on_container_move_assignment::value)
-          allocator() = std::move(alloc);
-        return *this;
-      }
-
-      using traits = std::allocator_traits<Allocator>;
-    protected:
-      Allocator& allocator() noexcept
-      {
-        return allocator_;
-      }
-
-      const Allocator& allocator() const noexcept
-      {
-        return allocator_;
-      }
-    private:
-      Allocator allocator_;
-    };
-
-    template<typename Allocator>
-    struct allocator_base<Allocator, std::enable_if_t<!std::is_final_v<Allocator>>> : protected Allocator // protected because intellisense thinks inherited members are still accessable >:(
-    {
-    public:
-      allocator_base() noexcept(noexcept(Allocator())) : Allocator(Allocator()) { }
-
-      allocator_base(const Allocator& alloc) noexcept : Allocator(traits::select_on_container_copy_construction(alloc)) { }
-
-      allocator_base(Allocator&& alloc) noexcept : Allocator(std::move(alloc)) { }
-
-      allocator_base operator=(const Allocator& alloc)
-      {
-        if constexpr (traits::propagate_on_container_copy_assignment::value)
-          allocator() = alloc;
-        return *this;
-      }
-
-      allocator_base operator=(Allocator&& alloc) 
-        noexcept(traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value)
-      {
-        if constexpr (traits::propagate_on_container_move_assignment::value)
-          allocator() = std::move(alloc);
-        return *this;
-      }
-
-      using traits = std::allocator_traits<Allocator>;
-    protected:
-      Allocator& allocator() noexcept
-      {
-        return *static_cast<Allocator*>(this);
-      }
-
-      const Allocator& allocator() const noexcept
-      {
-        return *static_cast<Allocator*>(this);
-      }
-    };
-
     template<typename Alloc, typename ForwardIt>
     void destroy_alloc(Alloc& alloc, ForwardIt first, ForwardIt last)
     {
-      if constexpr (!std::is_trivial_v<std::iterator_traits<ForwardIt>::value_type>)
+      if constexpr (!std::is_trivial_v<typename std::iterator_traits<ForwardIt>::value_type>)
         for (; first != last; ++first)
           std::allocator_traits<Alloc>::destroy(alloc, std::addressof(*first));
     }
@@ -135,7 +60,11 @@ namespace kstd
       using T = typename std::iterator_traits<InputIterator>::value_type;
 #ifdef ALLOW_UB
       if constexpr (std::is_trivial_v<T>)
-        return OutputIterator(std::memcpy(d_first, first, (last - first) * sizeof(T)));
+      {
+        if (first != last)
+          std::memcpy(d_first, first, (last - first) * sizeof(T));
+        return d_first + (last - first);
+      }
       else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
 #else
       if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
@@ -151,7 +80,11 @@ namespace kstd
       using T = typename std::iterator_traits<InputIterator>::value_type;
 #ifdef ALLOW_UB
       if constexpr (std::is_trivial_v<T>)
-        return OutputIterator(std::memcpy(d_first, first, (last - first) * sizeof(T)));
+      {
+        if (first != last)
+          std::memmove(d_first, first, (last - first) * sizeof(T));
+        return d_first + (last - first);
+      }
       else if constexpr (std::is_nothrow_move_assignable_v<T> || !std::is_copy_assignable_v<T>)
 #else
       if constexpr (std::is_nothrow_move_assignable_v<T> || !std::is_copy_assignable_v<T>)
@@ -162,19 +95,115 @@ namespace kstd
     }
 
     template<typename InputIterator, typename OutputIterator>
-    OutputIterator move_range_optimal_backward(InputIterator first, InputIterator last, OutputIterator d_first)
+    OutputIterator move_range_optimal_backward(InputIterator first, InputIterator last, OutputIterator d_last)
     {
       using T = typename std::iterator_traits<InputIterator>::value_type;
 #ifdef ALLOW_UB
       if constexpr (std::is_trivial_v<T>)
-        return OutputIterator(std::memmove(d_first, first, (last - first) * sizeof(T)));
+      {
+        if (first != last)
+          std::memmove(d_last - (last - first), first, (last - first) * sizeof(T));
+        return d_last - (last - first);
+      }
       else if constexpr (std::is_nothrow_move_assignable_v<T> || !std::is_copy_assignable_v<T>)
 #else
       if constexpr (std::is_nothrow_move_assignable_v<T> || !std::is_copy_assignable_v<T>)
 #endif
-        return std::move_backward(first, last, d_first);
+        return std::move_backward(first, last, d_last);
       else
-        return std::copy_backward(first, last, d_first);
+        return std::copy_backward(first, last, d_last);
+    }
+
+    // the source range is left without live objects; requires is_trivially_relocatable_v<T>
+    template<typename T>
+    T* relocate_range(T* first, T* last, T* d_first) noexcept
+    {
+      if (first != last)
+        std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), (last - first) * sizeof(T));
+      return d_first + (last - first);
+    }
+
+    // opens a gap of count elements at pos in a range ending at last, which has room for count more elements; returns
+    // how many slots at the front of the gap still hold moved-from elements, the rest are uninitialized
+    template<typename Alloc, typename T>
+    std::size_t shift_range_right_alloc(Alloc& alloc, T* pos, T* last, std::size_t count)
+    {
+      if (!count)
+        return 0;
+#ifdef ALLOW_UB
+      if constexpr (is_trivially_relocatable_v<T>)
+      {
+        relocate_range(pos, last, pos + count);
+        return 0;
+      }
+      else
+#endif
+      {
+        std::size_t live = std::min(std::size_t(last - pos), count);
+        uninitialized_move_range_optimal_alloc(alloc, last - live, last, last + count - live);
+        move_range_optimal_backward(pos, last - live, last - live + count);
+        return live;
+      }
+    }
+
+    // moves [first, last) into uninitialized storage at d_first, leaving a gap of count uninitialized elements where pos
+    // was; the source range is left without live objects
+    template<typename Alloc, typename T>
+    void relocate_range_gap_alloc(Alloc& alloc, T* first, T* pos, T* last, T* d_first, std::size_t count)
+    {
+#ifdef ALLOW_UB
+      if constexpr (is_trivially_relocatable_v<T>)
+      {
+        relocate_range(first, pos, d_first);
+        relocate_range(pos, last, d_first + (pos - first) + count);
+      }
+      else
+#endif
+      {
+        uninitialized_move_range_optimal_alloc(alloc, first, pos, d_first);
+        uninitialized_move_range_optimal_alloc(alloc, pos, last, d_first + (pos - first) + count);
+        destroy_alloc(alloc, first, last);
+      }
+    }
+
+    // removes [first, last) from a range ending at end, moving the tail down over it
+    template<typename Alloc, typename T>
+    void erase_range_alloc(Alloc& alloc, T* first, T* last, T* end)
+    {
+      if (first == last)
+        return;
+#ifdef ALLOW_UB
+      if constexpr (is_trivially_relocatable_v<T>)
+      {
+        destroy_alloc(alloc, first, last);
+        relocate_range(last, end, first);
+      }
+      else
+#endif
+      {
+        move_range_optimal(last, end, first);
+        destroy_alloc(alloc, end - (last - first), end);
+      }
+    }
+
+    // a single pass range cannot be measured up front, so it is appended and rotated into place; if an append throws,
+    // the appended elements are destroyed again and the container is left as it was
+    template<typename Container, typename InputIterator>
+    typename Container::iterator insert_single_pass(Container& c, std::size_t pos, InputIterator first, InputIterator last)
+    {
+      std::size_t size_old = c.size();
+      try
+      {
+        for (; first != last; ++first)
+          c.emplace_back(*first);
+      }
+      catch (...)
+      {
+        c.erase(c.begin() + size_old, c.end());
+        throw;
+      }
+      std::rotate(c.begin() + pos, c.begin() + size_old, c.end());
+      return c.begin() + pos;
     }
 
     template<typename InputIterator, typename OutputIterator>
@@ -182,8 +211,12 @@ namespace kstd
     {
 #ifdef ALLOW_UB
       using T = typename std::iterator_traits<InputIterator>::value_type;
-      if constexpr (std::is_trivial_v<T>)
-        return OutputIterator(std::memcpy(d_first, first, (last - first) * sizeof(T)));
+      if constexpr (std::is_trivial_v<T> && std::is_pointer_v<InputIterator>)
+      {
+        if (first != last)
+          std::memcpy(d_first, first, (last - first) * sizeof(T));
+        return d_first + (last - first);
+      }
       else
 #endif
         return std::copy(first, last, d_first);
@@ -194,8 +227,12 @@ namespace kstd
     {
 #ifdef ALLOW_UB
       using T = typename std::iterator_traits<InputIterator>::value_type;
-      if constexpr (std::is_trivial_v<T>)
-        return OutputIterator(std::memcpy(d_first, first, (last - first) * sizeof(T)));
+      if constexpr (std::is_trivial_v<T> && std::is_pointer_v<InputIterator>)
+      {
+        if (first != last)
+          std::memcpy(d_first, first, (last - first) * sizeof(T));
+        return d_first + (last - first);
+      }
       else
 #endif
         return uninitialized_copy_alloc(alloc, first, last, d_first);
@@ -216,7 +253,7 @@ namespace kstd
     template<typename Alloc, typename ForwardIterator>
     void uninitialized_default_fill_range_optimal_alloc(Alloc& alloc, ForwardIterator first, ForwardIterator last)
     {
-      if constexpr (!std::is_trivial_v<std::iterator_traits<ForwardIterator>::value_type>)
+      if constexpr (!std::is_trivial_v<typename std::iterator_traits<ForwardIterator>::value_type>)
         detail::uninitialized_default_fill_alloc(alloc, first, last);
     }
 
@@ -233,7 +270,45 @@ namespace kstd
     }
   }
 
-  template<typename T, typename Allocator = std::allocator<T>>
+  // growth policies: next_capacity returns the capacity to allocate when an insertion needs more than capacity elements
+
+  struct growth_2x
+  {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t) noexcept
+    {
+      return std::max(required, capacity * 2);
+    }
+  };
+
+  struct growth_1_5x
+  {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t) noexcept
+    {
+      return std::max(required, capacity + capacity / 2);
+    }
+  };
+
+  struct growth_exact
+  {
+    static std::size_t next_capacity(std::size_t, std::size_t required, std::size_t) noexcept
+    {
+      return required;
+    }
+  };
+
+  // doubles, then rounds the allocation up to whole pages so none of the tail page is wasted
+  template<std::size_t PageSize = 4096>
+  struct growth_page
+  {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t elem_size) noexcept
+    {
+      std::size_t bytes = std::max(required, capacity * 2) * elem_size;
+      bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+      return bytes / elem_size;
+    }
+  };
+
+  template<typename T, typename Allocator = std::allocator<T>, typename Growth = growth_2x>
   class vector : protected detail::allocator_base<Allocator>
   {
   public:
@@ -275,7 +350,7 @@ namespace kstd
       detail::uninitialized_copy_range_optimal_alloc(allocator(), first, last, data_);
     }
 
-    vector(const vector& other) : vector::allocator_base(other.allocator()), size_(other.size_)
+    vector(const vector& other) : vector::allocator_base(traits::select_on_container_copy_construction(other.allocator())), size_(other.size_)
     {
       reserve(other.capacity_);
       detail::uninitialized_copy_range_optimal_alloc(allocator(), other.data_, other.data_ + size_, data_);
@@ -331,6 +406,7 @@ namespace kstd
         detail::destroy_alloc(allocator(), data_ + other.size_, data_ + size_);
       }
       size_ = other.size_;
+      return *this;
     }
 
     vector& operator=(vector&& other) noexcept(noexcept(allocator() = Allocator()))
@@ -342,6 +418,7 @@ namespace kstd
       other.data_ = nullptr;
       other.size_ = 0;
       other.capacity_ = 0;
+      return *this;
     }
 
     vector& operator=(std::initializer_list<T> list)
@@ -358,6 +435,7 @@ namespace kstd
         detail::destroy_alloc(allocator(), data_ + list.size(), data_ + size_);
       }
       size_ = list.size();
+      return *this;
     }
 
     Allocator get_allocator() const noexcept
@@ -452,7 +530,8 @@ namespace kstd
       }
       else
       {
-        reserve(sz);
+        if (needs_to_reallocate(sz))
+          grow_offset(sz, size_, 0);
         detail::uninitialized_default_fill_range_optimal_alloc(allocator(), data_ + size_, data_ + sz);
       }
       size_ = sz;
@@ -468,7 +547,8 @@ namespace kstd
       }
       else
       {
-        reserve(sz);
+        if (needs_to_reallocate(sz))
+          grow_offset(sz, size_, 0);
         detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + size_, data_ + sz, value);
       }
       size_ = sz;
@@ -476,7 +556,7 @@ namespace kstd
 
     inline void reserve(size_type cap)
     {
-      if (needs_to_reallocate(cap + 1))
+      if (needs_to_reallocate(cap))
         reserve_offset(cap, size_, 0);
     }
 
@@ -545,24 +625,28 @@ namespace kstd
     template<typename... Args>
     reference emplace_back(Args&& ... args)
     {
-      reserve(size_ + 1);
-      traits::construct(allocator(), data_ + size_, std::forward<Args>(args)...);
+      if (needs_to_reallocate(size_ + 1))
+      {
+        T value(std::forward<Args>(args)...);
+        grow_offset(size_ + 1, size_, 0);
+        traits::construct(allocator(), data_ + size_, std::move(value));
+      }
+      else
+      {
+        traits::construct(allocator(), data_ + size_, std::forward<Args>(args)...);
+      }
       ++size_;
       return *(data_ + size_ - 1);
     }
 
     void push_back(const T& value)
     {
-      reserve(size_ + 1);
-      traits::construct(allocator(), data_ + size_, value);
-      ++size_;
+      emplace_back(value);
     }
 
     void push_back(T&& value)
     {
-      reserve(size_ + 1);
-      traits::construct(allocator(), data_ + size_, std::move(value));
-      ++size_;
+      emplace_back(std::move(value));
     }
 
     void pop_back()
@@ -576,10 +660,16 @@ namespace kstd
     iterator emplace(const_iterator pos, Args&& ... args)
     {
       size_type emplaced_pos = pos - begin();
-      if (!shift_elements_right(emplaced_pos, 1) && emplaced_pos < size_)
-        * (data_ + emplaced_pos) = T(std::forward<Args>(args)...);
-      else
-        traits::construct(allocator(), data_ + emplaced_pos, std::forward<Args>(args)...);
+      T value(std::forward<Args>(args)...);
+      if (needs_to_reallocate(size_ + 1))
+        grow_offset(size_ + 1, emplaced_pos, 1);
+      else if (detail::shift_range_right_alloc(allocator(), data_ + emplaced_pos, data_ + size_, 1))
+      {
+        *(data_ + emplaced_pos) = std::move(value);
+        ++size_;
+        return data_ + emplaced_pos;
+      }
+      traits::construct(allocator(), data_ + emplaced_pos, std::move(value));
       ++size_;
       return data_ + emplaced_pos;
     }
@@ -597,17 +687,18 @@ namespace kstd
     iterator insert(const_iterator pos, size_type count, const T& value)
     {
       size_type inserted_pos = pos - begin();
+      // value may be an element of this vector, which is about to move
+      T copy(value);
       if (needs_to_reallocate(size_ + count))
       {
-        reserve_offset(size_ + count, inserted_pos, count);
-        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos, data_ + inserted_pos + count, value);
+        grow_offset(size_ + count, inserted_pos, count);
+        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos, data_ + inserted_pos + count, copy);
       }
       else
       {
-        size_type uninit_to_copy = std::clamp((inserted_pos + count) - size_, size_type(0), count);
-        shift_elements_right(inserted_pos, count);
-        detail::fill_range_optimal(data_ + inserted_pos, data_ + inserted_pos + count - uninit_to_copy, value);
-        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos + count - uninit_to_copy, data_ + inserted_pos + count, value);
+        size_type live = detail::shift_range_right_alloc(allocator(), data_ + inserted_pos, data_ + size_, count);
+        detail::fill_range_optimal(data_ + inserted_pos, data_ + inserted_pos + live, copy);
+        detail::uninitialized_fill_range_optimal_alloc(allocator(), data_ + inserted_pos + live, data_ + inserted_pos + count, copy);
       }
       size_ += count;
       return data_ + inserted_pos;
@@ -620,15 +711,14 @@ namespace kstd
       size_type count = last - first;
       if (needs_to_reallocate(size_ + count))
       {
-        reserve_offset(size_ + count, inserted_pos, count);
+        grow_offset(size_ + count, inserted_pos, count);
         detail::uninitialized_copy_range_optimal_alloc(allocator(), first, last, data_ + inserted_pos);
       }
       else
       {
-        shift_elements_right(inserted_pos, count);
-        size_type uninit_to_copy = std::clamp((inserted_pos + count) - size_, size_type(0), count);
-        detail::copy_range_optimal(first, last - uninit_to_copy, data_ + inserted_pos);
-        detail::uninitialized_copy_range_optimal_alloc(allocator(), last - uninit_to_copy, last, data_ + inserted_pos + count - uninit_to_copy);
+        size_type live = detail::shift_range_right_alloc(allocator(), data_ + inserted_pos, data_ + size_, count);
+        detail::copy_range_optimal(first, first + live, data_ + inserted_pos);
+        detail::uninitialized_copy_range_optimal_alloc(allocator(), first + live, last, data_ + inserted_pos + live);
       }
       size_ += count;
       return data_ + inserted_pos;
@@ -643,10 +733,9 @@ namespace kstd
     {
       size_type count = last - first;
       size_type pos = first - begin();
-      detail::move_range_optimal(data_ + pos + count, data_ + size_, data_ + pos);
-      detail::destroy_alloc(allocator(), data_ + size_ - count, data_ + size_);
+      detail::erase_range_alloc(allocator(), data_ + pos, data_ + pos + count, data_ + size_);
       size_ -= count;
-      return data_ + pos + 1;
+      return data_ + pos;
     }
 
     iterator erase(const_iterator pos)
@@ -664,23 +753,31 @@ namespace kstd
       return cap > capacity_;
     }
 
-    void shift_elements_right(size_type pos, size_type count)
+    void grow_offset(size_type cap, size_type pos, size_type count)
     {
-      size_type uninit_to_move = std::clamp(size_ - pos, size_type(0), count);
-      detail::uninitialized_move_range_optimal_alloc(allocator(), data_ + size_ - uninit_to_move, data_ + size_, data_ + size_ + count - uninit_to_move);
-      detail::move_range_optimal_backward(data_ + pos, data_ + size_ - uninit_to_move, data_ + pos + count);
+      reserve_offset(std::max(cap, Growth::next_capacity(capacity_, cap, sizeof(T))), pos, count);
     }
 
-    bool reserve_offset(size_type cap, size_type pos, size_type count)
+    // reallocates to exactly new_cap elements, leaving a gap of count uninitialized elements at pos
+    bool reserve_offset(size_type new_cap, size_type pos, size_type count)
     {
-      size_type new_cap = capacity_ ? capacity_ : 1;
-      for (; new_cap <= cap; new_cap <<= 1);
+#ifdef ALLOW_UB
+      // lets the allocator grow the block in place or remap its pages instead of copying
+      if constexpr (is_trivially_relocatable_v<T> && detail::has_reallocate_v<Allocator>)
+      {
+        if (data_ != nullptr)
+        {
+          data_ = allocator().reallocate(data_, capacity_, new_cap);
+          detail::relocate_range(data_ + pos, data_ + size_, data_ + pos + count);
+          capacity_ = new_cap;
+          return true;
+        }
+      }
+#endif
       if (data_ != nullptr)
       {
         pointer new_data = traits::allocate(allocator(), new_cap);
-        detail::uninitialized_move_range_optimal_alloc(allocator(), data_, data_ + pos, new_data);
-        detail::uninitialized_move_range_optimal_alloc(allocator(), data_ + pos, data_ + size_, new_data + pos + count);
-        detail::destroy_alloc(allocator(), data_, data_ + size_);
+        detail::relocate_range_gap_alloc(allocator(), data_, data_ + pos, data_ + size_, new_data, count);
         traits::deallocate(allocator(), data_, capacity_);
         data_ = new_data;
       }
@@ -699,4 +796,7 @@ namespace kstd
     size_type size_ = 0;
     size_type capacity_ = 0;
   };
+
+  template<typename T, typename Allocator, typename Growth>
+  struct is_trivially_relocatable<vector<T, Allocator, Growth>> : std::bool_constant<std::is_empty_v<Allocator> || is_trivially_relocatable_v<Allocator>> { };
 }
\ No newline at end of file
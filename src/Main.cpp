@@ -1,5 +1,6 @@
 #include <iostream>
 #include "kvector.h"
+#include "kstring.h"
 #include <vector>
 #include <string>
 #include <chrono>
@@ -31,6 +32,19 @@ std::uint64_t vector_benchmark(std::uint64_t n)
   return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
 }
 
+template<typename String>
+double string_append_benchmark(std::size_t length, std::uint64_t n)
+{
+  String str;
+  str.resize(length, 'x');
+  str.reserve(length + n);
+  std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+  for (std::uint64_t i = 0; i < n; ++i)
+    str.append("x", 1);
+  std::chrono::time_point end = std::chrono::high_resolution_clock::now();
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / n;
+}
+
 int main()
 {
   constexpr uint64_t cycles = 2000;
@@ -46,6 +60,12 @@ int main()
   }
   std::cout << "std::vector: " << (counter_std / cycles) << " nanoseconds\n";
   std::cout << "kstd::vector: " << (counter_kstd / cycles) << " nanoseconds\n";
+  for (std::size_t length : {16, 1024, 65536, 1048576})
+  {
+    std::cout << "append at length " << length << ":\n";
+    std::cout << "  std::string: " << string_append_benchmark<std::string>(length, 100000) << " nanoseconds\n";
+    std::cout << "  kstd::string: " << string_append_benchmark<kstd::string>(length, 100000) << " nanoseconds\n";
+  }
   /*
   kstd::vector<bar> a;
   std::vector<bar> b = {bar("b1"), bar("b2"), bar("b3"), bar("b4"), bar("b5")};